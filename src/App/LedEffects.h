@@ -12,6 +12,8 @@
 
 #include "../Sys/SysModSystem.h"
 #include "LedModFixture.h"
+#include "LedParticles.h"
+#include "LedNoise.h"
 
 #ifdef STARLIGHT_USERMOD_AUDIOSYNC
   #include "../User/UserModAudioSync.h"
@@ -288,12 +290,6 @@ class RingRandomFlowEffect: public RingEffect {
 
 //BouncingBalls inspired by WLED
 #define maxNumBalls 16
-//each needs 12 bytes
-struct Ball {
-  unsigned long lastBounceTime;
-  float impactVelocity;
-  float height;
-};
 
 class BouncingBallsEffect: public Effect {
   const char * name() override {return "Bouncing Balls";}
@@ -303,7 +299,7 @@ class BouncingBallsEffect: public Effect {
   void setup(LedsLayer &leds, Variable parentVar) override {
     Effect::setup(leds, parentVar);
     ui->initSlider(parentVar, "gravity", leds.effectData.write<uint8_t>(128));
-    ui->initSlider(parentVar, "balls", leds.effectData.write<uint8_t>(8), 1, 16);
+    ui->initSlider(parentVar, "balls", leds.effectData.write<uint8_t>(8), 1, maxNumBalls);
   }
 
   void loop(LedsLayer &leds) override {
@@ -312,55 +308,44 @@ class BouncingBallsEffect: public Effect {
     uint8_t numBalls = leds.effectData.read<uint8_t>();
 
     //binding of loop persistent values (pointers)
-    Ball *balls = leds.effectData.readWrite<Ball>(maxNumBalls); //array
+    unsigned long *lastMillis = leds.effectData.readWrite<unsigned long>();
+    Particles balls;
+    if (!balls.bind(leds, maxNumBalls)) return;
 
     leds.fill_solid(CRGB::Black);
 
-    // non-chosen color is a random color
+    //time based, velocities in layer heights per second: heights 0..1 (one is the top of the layer), scaled to pixels when drawn
+    //  so big layers do not overflow 16.16
+    const int32_t top = Particles::one;
     const float gravity = -9.81f; // standard value of gravity
-    // const bool hasCol2 = SEGCOLOR(2);
-    const unsigned long time = sys->now;
+    const uint8_t timeScale = (255-grav)/64 + 1; //slow motion
+    unsigned long elapsed = *lastMillis?min(sys->now - *lastMillis, 100UL):0; //no big jumps after a pause
+    *lastMillis = sys->now;
 
-    //not necessary as effectData is cleared at setup(LedsLayer &leds)
-    // if (call == 0) {
-    //   for (size_t i = 0; i < maxNumBalls; i++) balls[i].lastBounceTime = time;
-    // }
+    while (*balls.count < numBalls) balls.add(0, 0, 0, 0, 0, 0, 0); //at the floor: launched below
+    while (*balls.count > numBalls) balls.remove(*balls.count - 1);
 
-    for (size_t i = 0; i < numBalls; i++) {
-      float timeSinceLastBounce = (time - balls[i].lastBounceTime)/((255-grav)/64 + 1);
-      float timeSec = timeSinceLastBounce/1000.0f;
-      balls[i].height = (0.5f * gravity * timeSec + balls[i].impactVelocity) * timeSec; // avoid use pow(x, 2) - its extremely slow !
+    balls.accelerate(gravity * top * elapsed / (1000 * timeScale), 0, 0);
+    balls.integrate(elapsed, 1000 * timeScale);
 
-      if (balls[i].height <= 0.0f) {
-        balls[i].height = 0.0f;
+    for (uint16_t i = 0; i < *balls.count; i++) {
+      if (balls.pos[0][i] <= 0) {
+        balls.pos[0][i] = 0;
         //damping for better effect using multiple balls
         float dampening = 0.9f - float(i)/float(numBalls * numBalls); // avoid use pow(x, 2) - its extremely slow !
-        balls[i].impactVelocity = dampening * balls[i].impactVelocity;
-        balls[i].lastBounceTime = time;
+        balls.vel[0][i] = balls.vel[0][i] < 0?-dampening * balls.vel[0][i]:0;
 
-        if (balls[i].impactVelocity < 0.015f) {
-          float impactVelocityStart = sqrtf(-2.0f * gravity) * random8(5,11)/10.0f; // randomize impact velocity
-          balls[i].impactVelocity = impactVelocityStart;
-        }
-      } else if (balls[i].height > 1.0f) {
+        if (balls.vel[0][i] < 0.015f * top)
+          balls.vel[0][i] = sqrtf(-2.0f * gravity) * random8(5,11)/10.0f * top; // randomize impact velocity
+      } else if (balls.pos[0][i] > top) {
         continue; // do not draw OOB ball
       }
 
-      // uint32_t color = SEGCOLOR(0);
-      // if (leds.palette) {
-      //   color = leds.color_wheel(i*(256/MAX(numBalls, 8)));
-      // } 
-      // else if (hasCol2) {
-      //   color = SEGCOLOR(i % NUM_COLORS);
-      // }
-
-      int pos = roundf(balls[i].height * (leds.size.x - 1));
+      int pos = ((int64_t)balls.pos[0][i] * (leds.size.x - 1) + Particles::one / 2) >> 16;
 
       CRGB color = ColorFromPalette(leds.palette, i*(256/max(numBalls, (uint8_t)8))); //error: no matching function for call to 'max(uint8_t&, int)'
 
       leds[pos] = color;
-      // if (leds.size.x<32) leds.setPixelColor(indexToVStrip(pos, stripNr), color); // encode virtual strip into index
-      // else           leds.setPixelColor(balls[i].height + (stripNr+1)*10.0f, color);
     } //balls
   }
 }; // BouncingBalls
@@ -479,15 +464,6 @@ class RainEffect: public Effect {
   }
 }; // RainEffect
 
-//each needs 19 bytes
-//Spark type is used for popcorn, fireworks, and drip
-struct Spark {
-  float pos, posX;
-  float vel, velX;
-  uint16_t col;
-  uint8_t colIndex;
-};
-
 #define maxNumDrops 6
 class DripEffect: public Effect {
   const char * name() override {return "Drip";}
@@ -497,11 +473,13 @@ class DripEffect: public Effect {
   void setup(LedsLayer &leds, Variable parentVar) override {
     Effect::setup(leds, parentVar);
     ui->initSlider(parentVar, "gravity", leds.effectData.write<uint8_t>(128), 1, 255);
-    ui->initSlider(parentVar, "drips", leds.effectData.write<uint8_t>(4), 1, 6);
+    ui->initSlider(parentVar, "drips", leds.effectData.write<uint8_t>(4), 1, maxNumDrops);
     ui->initSlider(parentVar, "swell", leds.effectData.write<uint8_t>(4), 1, 6);
     ui->initCheckBox(parentVar, "invert", leds.effectData.write<bool3State>(false));
   }
 
+  enum DropState {dropInit, dropForming, dropFalling, dropBouncing = 5}; //bouncing: 5 so less spread (7 - state)
+
   void loop(LedsLayer &leds) override {
     //Binding of controls. Keep before binding of vars and keep in same order as in setup()
     uint8_t grav = leds.effectData.read<uint8_t>();
@@ -510,7 +488,10 @@ class DripEffect: public Effect {
     bool3State invert = leds.effectData.read<bool3State>();
 
     //binding of loop persistent values (pointers)
-    Spark* drops = leds.effectData.readWrite<Spark>(maxNumDrops);
+    Particles drops; //life is the brightness of the drop
+    if (!drops.bind(leds, maxNumDrops)) return;
+    uint8_t *state = leds.effectData.readWrite<uint8_t>(maxNumDrops);
+    if (state == nullptr) return;
 
     // leds.fadeToBlackBy(90);
     leds.fill_solid(CRGB::Black);
@@ -519,55 +500,57 @@ class DripEffect: public Effect {
     gravity *= max(1, leds.size.x-1);
     int sourcedrop = 12;
 
-    for (int j=0;j<drips;j++) {
-      if (drops[j].colIndex == 0) { //init
-        drops[j].pos = leds.size.x-1;    // start at end
-        drops[j].vel = 0;           // speed
-        drops[j].col = sourcedrop;  // brightness
-        drops[j].colIndex = 1;      // drop state (0 init, 1 forming, 2 falling, 5 bouncing)
-        drops[j].velX = (uint32_t)ColorFromPalette(leds.palette, random8()); // random color
+    while (*drops.count < drips) state[drops.add(0, 0, 0, 0, 0, 0, 0)] = dropInit;
+    while (*drops.count > drips) drops.remove(*drops.count - 1); //last one: no state to move
+
+    for (int j=0;j<*drops.count;j++) {
+      int32_t &pos = drops.pos[0][j];
+      int32_t &vel = drops.vel[0][j];
+      uint16_t &brightness = drops.life[j];
+      if (state[j] == dropInit) {
+        pos = (leds.size.x-1) * Particles::one; // start at end
+        vel = 0;                        // speed
+        brightness = sourcedrop;
+        state[j] = dropForming;
+        drops.colorIndex[j] = random8(); // random color
       }
-      CRGB dropColor = drops[j].velX;
+      CRGB dropColor = ColorFromPalette(leds.palette, drops.colorIndex[j]);
 
       leds.setPixelColor(invert?0:leds.size.x-1, blend(CRGB::Black, dropColor, sourcedrop));// water source
-      if (drops[j].colIndex==1) {
-        if (drops[j].col>255) drops[j].col=255;
-        leds.setPixelColor(invert?leds.size.x-1-drops[j].pos:drops[j].pos, blend(CRGB::Black, dropColor, drops[j].col));
+      if (state[j] == dropForming) {
+        if (brightness>255) brightness=255;
+        int pixel = pos >> 16;
+        leds.setPixelColor(invert?leds.size.x-1-pixel:pixel, blend(CRGB::Black, dropColor, brightness));
 
-        drops[j].col += swell; // swelling
+        brightness += swell; // swelling
 
-        if (random16() <= drops[j].col * swell * swell / 10) {               // random drop
-          drops[j].colIndex=2;               //fall
-          drops[j].col=255;
+        if (random16() <= brightness * swell * swell / 10) { // random drop
+          state[j] = dropFalling;
+          brightness = 255;
         }
       }
-      if (drops[j].colIndex > 1) {           // falling
-        if (drops[j].pos > 0) {              // fall until end of segment
-          drops[j].pos += drops[j].vel;
-          if (drops[j].pos < 0) drops[j].pos = 0;
-          drops[j].vel += gravity;           // gravity is negative
+      if (state[j] > dropForming) {           // falling
+        if (pos > 0) {                        // fall until end of segment
+          pos += vel;
+          if (pos < 0) pos = 0;
+          vel += gravity * Particles::one;    // gravity is negative
 
-          for (int i=1;i<7-drops[j].colIndex;i++) { // some minor math so we don't expand bouncing droplets
-            uint16_t pos = constrain(uint16_t(drops[j].pos) +i, 0, leds.size.x-1); //this is BAD, returns a pos >= leds.size.x occasionally
-            leds.setPixelColor(invert?leds.size.x-1-pos:pos, blend(CRGB::Black, dropColor, drops[j].col/i)); //spread pixel with fade while falling
+          for (int i=1;i<7-state[j];i++) { // some minor math so we don't expand bouncing droplets
+            uint16_t pixel = constrain((pos >> 16) + i, 0, leds.size.x-1);
+            leds.setPixelColor(invert?leds.size.x-1-pixel:pixel, blend(CRGB::Black, dropColor, brightness/i)); //spread pixel with fade while falling
           }
 
-          if (drops[j].colIndex > 2) {       // during bounce, some water is on the floor
-            leds.setPixelColor(invert?leds.size.x-1:0, blend(dropColor, CRGB::Black, drops[j].col));
+          if (state[j] > dropFalling) {       // during bounce, some water is on the floor
+            leds.setPixelColor(invert?leds.size.x-1:0, blend(dropColor, CRGB::Black, brightness));
           }
         } else {                             // we hit bottom
-          if (drops[j].colIndex > 2) {       // already hit once, so back to forming
-            drops[j].colIndex = 0;
-            // drops[j].col = sourcedrop;
-
+          if (state[j] > dropFalling) {       // already hit once, so back to forming
+            state[j] = dropInit;
           } else {
-
-            if (drops[j].colIndex==2) {      // init bounce
-              drops[j].vel = -drops[j].vel/4;// reverse velocity with damping
-              drops[j].pos += drops[j].vel;
-            }
-            drops[j].col = sourcedrop*2;
-            drops[j].colIndex = 5;           // bouncing
+            vel = -vel/4;                    // init bounce: reverse velocity with damping
+            pos += vel;
+            brightness = sourcedrop*2;
+            state[j] = dropBouncing;
           }
         }
       }
@@ -706,7 +689,8 @@ class PopCornEffect: public Effect {
     #endif
 
     //binding of loop persistent values (pointers)
-    Spark *popcorn = leds.effectData.readWrite<Spark>(maxNumPopcorn); //array
+    Particles corns;
+    if (!corns.bind(leds, maxNumPopcorn)) return;
 
     leds.fill_solid(CRGB::Black);
 
@@ -715,48 +699,39 @@ class PopCornEffect: public Effect {
 
     if (numPopcorn == 0) numPopcorn = 1;
 
-    for (int i = 0; i < numPopcorn; i++) {
-      if (popcorn[i].pos >= 0.0f) { // if kernel is active, update its position
-        popcorn[i].pos += popcorn[i].vel;
-        popcorn[i].vel += gravity;
-      } else { // if kernel is inactive, randomly pop it
-        bool doPopCorn = false;  // WLEDMM allows to inhibit new pops
-        // WLEDMM begin
-        #ifdef STARLIGHT_USERMOD_AUDIOSYNC
-          if (useaudio) {
-            if (  (audioSync->sync.volumeSmth > 1.0f)                      // no pops in silence
-                // &&((audioSync->sync.samplePeak > 0) || (audioSync->sync.volumeRaw > 128))  // try to pop at onsets (our peek detector still sucks)
-                &&(random8() < 4) )                        // stay somewhat random
-              doPopCorn = true;
-          } else {         
-            if (random8() < 2) doPopCorn = true; // default POP!!!
-          }
-        #endif
-
-        if (doPopCorn) { // POP!!!
-          popcorn[i].pos = 0.01f;
-
-          uint16_t peakHeight = 128 + random8(128); //0-255
-          peakHeight = (peakHeight * (leds.size.x -1)) >> 8;
-          popcorn[i].vel = sqrtf(-2.0f * gravity * peakHeight);
-
-          // if (leds.palette)
-          // {
-            popcorn[i].colIndex = random8();
-          // } else {
-          //   byte col = random8(0, NUM_COLORS);
-          //   if (!SEGCOLOR(2) || !SEGCOLOR(col)) col = 0;
-          //   popcorn[i].colIndex = col;
-          // }
+    // update active kernels, kernels which fell down (or are above the number of corns) are removed
+    corns.integrate();
+    corns.accelerate(gravity * Particles::one, 0, 0);
+    for (int i = *corns.count - 1; i >= 0; i--)
+      if (corns.pos[0][i] < 0 || i >= numPopcorn) corns.remove(i);
+
+    // randomly pop inactive kernels
+    for (int i = *corns.count; i < numPopcorn; i++) {
+      bool doPopCorn = false;  // WLEDMM allows to inhibit new pops
+      // WLEDMM begin
+      #ifdef STARLIGHT_USERMOD_AUDIOSYNC
+        if (useaudio) {
+          if (  (audioSync->sync.volumeSmth > 1.0f)                      // no pops in silence
+              // &&((audioSync->sync.samplePeak > 0) || (audioSync->sync.volumeRaw > 128))  // try to pop at onsets (our peek detector still sucks)
+              &&(random8() < 4) )                        // stay somewhat random
+            doPopCorn = true;
+        } else {         
+          if (random8() < 2) doPopCorn = true; // default POP!!!
         }
+      #endif
+
+      if (doPopCorn) { // POP!!!
+        uint16_t peakHeight = 128 + random8(128); //0-255
+        peakHeight = (peakHeight * (leds.size.x -1)) >> 8;
+        corns.add(0.01f * Particles::one, 0, 0, sqrtf(-2.0f * gravity * peakHeight) * Particles::one, 0, 0, random8());
       }
-      if (popcorn[i].pos >= 0.0f) { // draw now active popcorn (either active before or just popped)
-        // uint32_t col = leds.color_wheel(popcorn[i].colIndex);
-        // if (!leds.palette && popcorn[i].colIndex < NUM_COLORS) col = SEGCOLOR(popcorn[i].colIndex);
-        uint16_t ledIndex = popcorn[i].pos;
-        CRGB col = ColorFromPalette(leds.palette, popcorn[i].colIndex*(256/maxNumPopcorn));
-        if (ledIndex < leds.size.x) leds.setPixelColor(ledIndex, col);
-      }
+    }
+
+    // draw active popcorn (either active before or just popped)
+    for (int i = 0; i < *corns.count; i++) {
+      uint16_t ledIndex = corns.pos[0][i] >> 16;
+      CRGB col = ColorFromPalette(leds.palette, corns.colorIndex[i]*(256/maxNumPopcorn));
+      if (ledIndex < leds.size.x) leds.setPixelColor(ledIndex, col);
     }
   }
 }; //PopCorn
@@ -970,19 +945,13 @@ class LinesEffect: public Effect {
           leds[j+i*256]=CRGB::Red; //no projection => ledsV = ledsP
       }
     } else {
-      Coord3D pos = {0,0,0};
-      pos.x = map(beat16( bpm), 0, UINT16_MAX, 0, leds.size.x ); //instead of call%width
+      int x = map(beat16( bpm), 0, UINT16_MAX, 0, leds.size.x ); //instead of call%width
+      int colorNr = (*frameNr / leds.size.y) % 3;
+      leds.drawLine(x, 0, x, leds.size.y - 1, colorNr == 0?CRGB::Red:colorNr == 1?CRGB::Green:CRGB::Blue);
 
-      for (pos.y = 0; pos.y <  leds.size.y; pos.y++) {
-        int colorNr = (*frameNr / leds.size.y) % 3;
-        leds[pos] = colorNr == 0?CRGB::Red:colorNr == 1?CRGB::Green:CRGB::Blue;
-      }
-      pos = {0,0,0};
-      pos.y = map(beat16( bpm), 0, UINT16_MAX, 0, leds.size.y ); //instead of call%height
-      for (pos.x = 0; pos.x <  leds.size.x; pos.x++) {
-        int colorNr = (*frameNr / leds.size.x) % 3;
-        leds[pos] = colorNr == 0?CRGB::Red:colorNr == 1?CRGB::Green:CRGB::Blue;
-      }
+      int y = map(beat16( bpm), 0, UINT16_MAX, 0, leds.size.y ); //instead of call%height
+      colorNr = (*frameNr / leds.size.x) % 3;
+      leds.drawLine(0, y, leds.size.x - 1, y, colorNr == 0?CRGB::Red:colorNr == 1?CRGB::Green:CRGB::Blue); //one span
       (*frameNr)++;
     }
   }
@@ -1099,15 +1068,23 @@ class DistortionWavesEffect: public Effect {
   uint8_t dim() override {return _2D;}
   const char * tags() override {return "💡";}
   
+  struct State {
+    uint8_t speed = 4;
+    uint8_t scale = 4;
+  };
+
   void setup(LedsLayer &leds, Variable parentVar) override {
-    ui->initSlider(parentVar, "speed", leds.effectData.write<uint8_t>(4), 0, 8);
-    ui->initSlider(parentVar, "scale", leds.effectData.write<uint8_t>(4), 0, 8);
+    State *state = leds.effectData.state<State>();
+    if (!state) return;
+    ui->initSlider(parentVar, "speed", &state->speed, 0, 8);
+    ui->initSlider(parentVar, "scale", &state->scale, 0, 8);
   }
 
   void loop(LedsLayer &leds) override {
-    //Binding of controls. Keep before binding of vars and keep in same order as in setup()
-    uint8_t speed = leds.effectData.read<uint8_t>(); 
-    uint8_t scale = leds.effectData.read<uint8_t>(); 
+    State *state = leds.effectData.state<State>();
+    if (!state) return;
+    uint8_t speed = state->speed;
+    uint8_t scale = state->scale;
 
     uint8_t  w = 2;
 
@@ -1122,14 +1099,15 @@ class DistortionWavesEffect: public Effect {
     uint16_t cx2 = beatsin8(17-speed,0,leds.size.x-1)*scale;
     uint16_t cy2 = beatsin8(14-speed,0,leds.size.y-1)*scale;
     
-    uint16_t xoffs = 0;
+    CRGB *row = leds.spanBuffer(leds.size.x);
     Coord3D pos = {0,0,0};
-    for (pos.x = 0; pos.x < leds.size.x; pos.x++) {
-      xoffs += scale;
-      uint16_t yoffs = 0;
+    uint16_t yoffs = 0;
+    for (pos.y = 0; pos.y < leds.size.y; pos.y++) {
+      yoffs += scale;
+      uint16_t xoffs = 0;
 
-      for (pos.y = 0; pos.y < leds.size.y; pos.y++) {
-        yoffs += scale;
+      for (pos.x = 0; pos.x < leds.size.x; pos.x++) {
+        xoffs += scale;
 
         byte rdistort = cos8((cos8(((pos.x<<3)+a )&255)+cos8(((pos.y<<3)-a2)&255)+a3   )&255)>>1; 
         byte gdistort = cos8((cos8(((pos.x<<3)-a2)&255)+cos8(((pos.y<<3)+a3)&255)+a+32 )&255)>>1; 
@@ -1143,8 +1121,9 @@ class DistortionWavesEffect: public Effect {
         valueG = gamma8(cos8(valueG));
         valueB = gamma8(cos8(valueB));
 
-        leds[pos] = CRGB(valueR, valueG, valueB);
+        row[pos.x] = CRGB(valueR, valueG, valueB);
       }
+      leds.writeRow(pos.y, row);
     }
   }
 }; // DistortionWaves
@@ -1156,88 +1135,80 @@ class OctopusEffect: public Effect {
   uint8_t dim() override {return _2D;}
   const char * tags() override {return "💡";}
 
-  struct Map_t {
-    uint8_t angle;
-    uint8_t radius;
+  struct State {
+    uint8_t speed = 128;
+    uint8_t offsetX = 128;
+    uint8_t offsetY = 128;
+    uint8_t legs = 4;
+    bool3State radialWave = false;
+    uint32_t step = 0;
+  };
+
+  struct Cache {
+    uint8_t mapp; //radius scale
   };
 
+  void resize(LedsLayer &leds) override {
+    Cache *cache = leds.effectCache.state<Cache>();
+    if (cache) cache->mapp = 180 / max(leds.size.x,leds.size.y);
+  }
+
   void setup(LedsLayer &leds, Variable parentVar) override {
     Effect::setup(leds, parentVar); //palette
-    bool3State *setup = leds.effectData.write<bool3State>(true);
-    ui->initSlider(parentVar, "speed", leds.effectData.write<uint8_t>(128), 1, 255);
-    ui->initSlider(parentVar, "offsetX", leds.effectData.write<uint8_t>(128), 0, 255, false, [setup] (EventArguments) { switch (eventType) {
-      case onChange: {*setup = true; return true;}
-      default: return false;
-    }});
-    ui->initSlider(parentVar, "offsetY", leds.effectData.write<uint8_t>(128), 0, 255, false, [setup] (EventArguments) { switch (eventType) {
-      case onChange: {*setup = true; return true;}
-      default: return false;
-    }});
-    ui->initSlider(parentVar, "legs", leds.effectData.write<uint8_t>(4), 1, 8);
+    State *state = leds.effectData.state<State>();
+    if (!state) return;
+    ui->initSlider(parentVar, "speed", &state->speed, 1, 255);
+    ui->initSlider(parentVar, "offsetX", &state->offsetX, 0, 255);
+    ui->initSlider(parentVar, "offsetY", &state->offsetY, 0, 255);
+    ui->initSlider(parentVar, "legs", &state->legs, 1, 8);
 
-    ui->initCheckBox(parentVar, "radialWave", leds.effectData.write<bool3State>(false));
+    ui->initCheckBox(parentVar, "radialWave", &state->radialWave);
   }
 
   void loop(LedsLayer &leds) override {
-    //Binding of controls. Keep before binding of vars and keep in same order as in setup()
-    bool3State   *setup = leds.effectData.readWrite<bool3State>();
-    uint8_t speed = leds.effectData.read<uint8_t>();
-    uint8_t offsetX = leds.effectData.read<uint8_t>();
-    uint8_t offsetY = leds.effectData.read<uint8_t>();
-    uint8_t legs = leds.effectData.read<uint8_t>();
-    bool radialWave = leds.effectData.read<bool3State>();
+    State *state = leds.effectData.state<State>();
+    const Cache *cache = leds.effectCache.state<Cache>();
 
-    // Effect Variables
-    Coord3D  *prevLedSize = leds.effectData.readWrite<Coord3D>();
-    Map_t    *rMap = leds.effectData.readWrite<Map_t>(leds.size.x * leds.size.y); //array
-    uint32_t *step = leds.effectData.readWrite<uint32_t>();
+    if (state && cache) {
+      uint8_t speed = state->speed;
+      uint8_t offsetX = state->offsetX;
+      uint8_t offsetY = state->offsetY;
+      uint8_t legs = state->legs;
+      bool radialWave = state->radialWave;
+      uint32_t *step = &state->step;
 
-    if (leds.effectData.success()) { //octopus allocates quite a lot, so worth checking
+      const uint8_t mapp = cache->mapp;
 
-      const uint8_t mapp = 180 / max(leds.size.x,leds.size.y);
+      // polar map shared with other radial effects, rebuilt only if leds.size or offset changes
+      const int C_X = leds.size.x / 2 + (offsetX - 128)*leds.size.x/255;
+      const int C_Y = leds.size.y / 2 + (offsetY - 128)*leds.size.y/255;
+      const RadialField &field = leds.radial(Coord3D{2 * C_X, 2 * C_Y, 0}, Coord3D{leds.size.x, leds.size.y, 1});
 
       Coord3D pos = {0,0,0};
 
-      if (*setup || *prevLedSize != leds.size) { // Setup map if leds.size or offset changes
-        *setup = false;
-        *prevLedSize = leds.size;
-        const uint8_t C_X = leds.size.x / 2 + (offsetX - 128)*leds.size.x/255;
-        const uint8_t C_Y = leds.size.y / 2 + (offsetY - 128)*leds.size.y/255;
-        for (pos.x = 0; pos.x < leds.size.x; pos.x++) {
-          for (pos.y = 0; pos.y < leds.size.y; pos.y++) {
-            uint16_t indexV = leds.XYZUnprojected(pos);
-            if (indexV < leds.size.x * leds.size.y) { //excluding UINT16_MAX from XY if out of bounds due to projection
-              rMap[indexV].angle = 40.7436f * atan2f(pos.y - C_Y, pos.x - C_X); // avoid 128*atan2()/PI
-              rMap[indexV].radius = hypotf(pos.x - C_X, pos.y - C_Y) * mapp; //thanks Sutaburosu
-            }
-          }
-        }
-      }
-
-      
       *step = sys->now * speed / 32 / 25; //sys.now/25 = 40 per second. speed / 32: 1-4 range ? (1-8 ??)
       if (radialWave)
         *step = 3 * (*step) / 4; // 7/6 = 1.16 for RadialWave mode
       else
         *step = (*step) / 2; // 1/2 for Octopus mode
 
-      for (pos.x = 0; pos.x < leds.size.x; pos.x++) {
-        for (pos.y = 0; pos.y < leds.size.y; pos.y++) {
-          uint16_t indexV = leds.XYZUnprojected(pos);
-          if (indexV < leds.size.x * leds.size.y) { //excluding UINT16_MAX from XY if out of bounds due to projection
-            byte angle = rMap[indexV].angle;
-            byte radius = rMap[indexV].radius;
-            uint16_t intensity;
-            if (radialWave)
-              intensity = sin8(*step + sin8(*step - radius) + angle * legs);                               // RadialWave
-            else
-              intensity = sin8(sin8((angle * 4 - radius) / 4 + (*step)/2) + radius - (*step) + angle * legs); //octopus
-            intensity = intensity * intensity / 255; // add a bit of non-linearity for cleaner display
-            leds[pos] = ColorFromPalette(leds.palette, (*step) / 2 - radius, intensity);
-          }
+      CRGB *row = leds.spanBuffer(leds.size.x);
+      for (pos.y = 0; pos.y < leds.size.y; pos.y++) {
+        for (pos.x = 0; pos.x < leds.size.x; pos.x++) {
+          const RadialField::Polar &polar = field.at(pos);
+          byte angle = polar.angle >> 8; // 256 per circle
+          byte radius = polar.distance * mapp / 16; //thanks Sutaburosu
+          uint16_t intensity;
+          if (radialWave)
+            intensity = sin8(*step + sin8(*step - radius) + angle * legs);                               // RadialWave
+          else
+            intensity = sin8(sin8((angle * 4 - radius) / 4 + (*step)/2) + radius - (*step) + angle * legs); //octopus
+          intensity = intensity * intensity / 255; // add a bit of non-linearity for cleaner display
+          row[pos.x] = ColorFromPalette(leds.palette, (*step) / 2 - radius, intensity);
         }
+        leds.writeRow(pos.y, row);
       }
-    } //if (leds.effectData.success())
+    } //if (state)
   }
   
 }; // Octopus
@@ -1264,12 +1235,31 @@ class FireEffect: public Effect {
 
   const uint8_t NCOLORS = (sizeof(colors)/sizeof(colors[0]));
 
+  static constexpr int distanceSize = 32; //distance table of glow for offsets up to 32 pixels
+
+  //isqrt of the offsets, instead of recursive isqrt for each pixel of each glow. Does not depend on the layer: built once, shared by all layers
+  struct DistanceTable {
+    uint8_t distance[distanceSize][distanceSize];
+    DistanceTable() {
+      for (int dy = 0; dy < distanceSize; dy++)
+        for (int dx = 0; dx < distanceSize; dx++)
+          distance[dy][dx] = isqrt(dx * dx + dy * dy);
+    }
+  };
+  static const DistanceTable &distanceTable() {
+    static const DistanceTable table;
+    return table;
+  }
+
   void glow(int x, int y, int z, uint8_t flareDecay, LedsLayer &leds, bool usePalette) {
+    if (flareDecay == 0) flareDecay = 1;
+    const DistanceTable &table = distanceTable();
     int b = z * 10 / flareDecay + 1;
     for ( int i=(y-b); i<(y+b); ++i ) {
       for ( int j=(x-b); j<(x+b); ++j ) {
         if ( i >=0 && j >= 0 && i < leds.size.y && j < leds.size.x ) {
-          int d = ( flareDecay * isqrt((x-j)*(x-j) + (y-i)*(y-i)) + 5 ) / 10;
+          const int dx = abs(x-j), dy = abs(y-i);
+          int d = ( flareDecay * ((dx < distanceSize && dy < distanceSize)?table.distance[dy][dx]:isqrt(dx*dx + dy*dy)) + 5 ) / 10;
           uint8_t n = 0;
           if ( z > d ) n = z - d;
           if ( leds[leds.XY(j, leds.size.y - 1 - i)] < usePalette?ColorFromPalette(leds.palette, n*23): colors[n]) { // can only get brighter
@@ -1281,7 +1271,7 @@ class FireEffect: public Effect {
   }
 
   //utility function?
-  uint32_t isqrt(uint32_t n) {
+  static uint32_t isqrt(uint32_t n) {
     if ( n < 2 ) return n;
     uint32_t smallCandidate = isqrt(n >> 2) << 1;
     uint32_t largeCandidate = smallCandidate + 1;
@@ -1381,7 +1371,18 @@ class LissajousEffect: public Effect {
     ui->initSlider(parentVar, "xFrequency", leds.effectData.write<uint8_t>(64));
     ui->initSlider(parentVar, "fadeRate", leds.effectData.write<uint8_t>(128));
     ui->initSlider(parentVar, "speed", leds.effectData.write<uint8_t>(128));
-    ui->initCheckBox(parentVar, "smooth", leds.effectData.write<bool3State>(false)); //true: not working at the moment
+    ui->initCheckBox(parentVar, "smooth", leds.effectData.write<bool3State>(false));
+  }
+
+  //pixel of sin8 / cos8 values, instead of 2 map() per point per frame
+  void resize(LedsLayer &leds) override {
+    uint16_t *xLocn = leds.effectCache.readWrite<uint16_t>(256);
+    uint16_t *yLocn = leds.effectCache.readWrite<uint16_t>(256);
+    if (!leds.effectCache.success()) return;
+    for (int i = 0; i < 256; i++) {
+      xLocn[i] = (leds.size.x < 2) ? 1 : (map(2*i, 0,511, 0,2*(leds.size.x-1)) +1) /2;    // softhack007: "*2 +1" for proper rounding
+      yLocn[i] = (leds.size.y < 2) ? 1 : (map(2*i, 0,511, 0,2*(leds.size.y-1)) +1) /2;    // "leds.size.y > 2" is needed to avoid div/0 in map()
+    }
   }
 
   void loop(LedsLayer &leds) override {
@@ -1400,24 +1401,26 @@ class LissajousEffect: public Effect {
         int maxLoops = max(192U, 4U*(leds.size.x+leds.size.y));
         maxLoops = ((maxLoops / 128) +1) * 128; // make sure whe have half or full turns => multiples of 128
         for (int i=0; i < maxLoops; i++) {
-          locn.x = float(sin8(phase/2 + (i* xFrequency)/64)) / 255.0f;  // WLEDMM align speed with original effect
-          locn.y = float(cos8(phase/2 + i*2)) / 255.0f;
-          //leds.setPixelColor(xlocn, ylocn, leds.color_from_palette(sys->now/100+i, false, PALETTE_SOLID_WRAP, 0)); // draw pixel with anti-aliasing
-          unsigned palIndex = (256*locn.y) + phase/2 + (i* xFrequency)/64;
-          // leds.setPixelColor(xlocn, ylocn, leds.color_from_palette(palIndex, false, PALETTE_SOLID_WRAP, 0)); // draw pixel with anti-aliasing - color follows rotation
-          // leds[locn] = ColorFromPalette(leds.palette, palIndex);
-          leds.setPixelColorPal(locn, palIndex);
+          float xlocn = float(sin8(phase/2 + (i* xFrequency)/64)) / 255.0f;  // WLEDMM align speed with original effect
+          float ylocn = float(cos8(phase/2 + i*2)) / 255.0f;
+          unsigned palIndex = (256*ylocn) + phase/2 + (i* xFrequency)/64;
+          // draw pixel with anti-aliasing - color follows rotation
+          leds.rasterPoint(xlocn * (leds.size.x - 1), ylocn * (leds.size.y - 1));
+          leds.compositeFragments(ColorFromPalette(leds.palette, palIndex));
         }
-    } else
-    for (int i=0; i < 256; i ++) {
-      //WLEDMM: stick to the original calculations of xlocn and ylocn
-      locn.x = sin8(phase/2 + (i*xFrequency)/64);
-      locn.y = cos8(phase/2 + i*2);
-      locn.x = (leds.size.x < 2) ? 1 : (map(2*locn.x, 0,511, 0,2*(leds.size.x-1)) +1) /2;    // softhack007: "*2 +1" for proper rounding
-      locn.y = (leds.size.y < 2) ? 1 : (map(2*locn.y, 0,511, 0,2*(leds.size.y-1)) +1) /2;    // "leds.size.y > 2" is needed to avoid div/0 in map()
-      // leds.setPixelColor((uint8_t)xlocn, (uint8_t)ylocn, leds.color_from_palette(sys->now/100+i, false, PALETTE_SOLID_WRAP, 0));
-      // leds[locn] = ColorFromPalette(leds.palette, sys->now/100+i);
-      leds.setPixelColorPal(locn, sys->now/100+i);
+    } else {
+      leds.effectCache.begin();
+      const uint16_t *xLocn = leds.effectCache.readWrite<uint16_t>(256);
+      const uint16_t *yLocn = leds.effectCache.readWrite<uint16_t>(256);
+      if (!leds.effectCache.success()) return;
+      for (int i=0; i < 256; i ++) {
+        //WLEDMM: stick to the original calculations of xlocn and ylocn (see resize)
+        locn.x = xLocn[sin8(phase/2 + (i*xFrequency)/64)];
+        locn.y = yLocn[cos8(phase/2 + i*2)];
+        // leds.setPixelColor((uint8_t)xlocn, (uint8_t)ylocn, leds.color_from_palette(sys->now/100+i, false, PALETTE_SOLID_WRAP, 0));
+        // leds[locn] = ColorFromPalette(leds.palette, sys->now/100+i);
+        leds.setPixelColorPal(locn, sys->now/100+i);
+      }
     }
   }
   
@@ -1498,23 +1501,43 @@ class Noise2DEffect: public Effect {
   uint8_t dim() override {return _2D;}
   const char * tags() override {return "💡";}
   
+  struct State {
+    uint8_t speed = 8;
+    uint8_t scale = 64;
+  };
+
   void setup(LedsLayer &leds, Variable parentVar) override {
     Effect::setup(leds, parentVar);
 
-    ui->initSlider(parentVar, "speed", leds.effectData.write<uint8_t>(8), 0, 15);
-    ui->initSlider(parentVar, "scale", leds.effectData.write<uint8_t>(64), 2, 255);
+    State *state = leds.effectData.state<State>();
+    if (!state) return;
+    ui->initSlider(parentVar, "speed", &state->speed, 0, 15);
+    ui->initSlider(parentVar, "scale", &state->scale, 2, 255);
   }
 
   void loop(LedsLayer &leds) override {
-    //Binding of controls. Keep before binding of vars and keep in same order as in setup()
-    uint8_t speed = leds.effectData.read<uint8_t>();
-    uint8_t scale = leds.effectData.read<uint8_t>();
+    State *state = leds.effectData.state<State>();
+    if (!state) return;
+    uint8_t speed = state->speed;
+    uint8_t scale = state->scale;
+
+    uint32_t z = sys->now / (16 - speed);
 
-    for (int y = 0; y < leds.size.y; y++) {
-      for (int x = 0; x < leds.size.x; x++) {
-        uint8_t pixelHue8 = inoise8(x * scale, y * scale, sys->now / (16 - speed));
-        // leds.setPixelColor(x, y, ColorFromPalette(leds.palette, pixelHue8));
-        leds.setPixelColorPal(leds.XY(x, y), pixelHue8);
+    if (speed <= 12) { //slow enough (keyframe every 16 z units >= 3 ms * 16): interpolate between cached keyframes
+      NoiseCache cache;
+      if (!cache.bind(leds)) return;
+      cache.update(0, scale, 0, scale, z, 4);
+      uint8_t *row = leds.spanIndexBuffer(leds.size.x);
+      for (int y = 0; y < leds.size.y; y++) {
+        cache.row(row, y);
+        leds.writeRowPal(y, row);
+      }
+    }
+    else {
+      uint8_t *row = leds.spanIndexBuffer(leds.size.x);
+      for (int y = 0; y < leds.size.y; y++) {
+        inoise8Row(row, leds.size.x, 0, scale, y * scale, z);
+        leds.writeRowPal(y, row);
       }
     }
   }
@@ -1548,22 +1571,105 @@ uint16_t lcm(uint16_t a, uint16_t b) {
   return a / gcd(a, b) * b;
 }
 
-//utility function
-static bool getBitValue(const byte* byteArray, size_t n) {
-    size_t byteIndex = n / 8;
-    size_t bitIndex = n % 8;
-    uint8_t byte = byteArray[byteIndex];
-    return (byte >> bitIndex) & 1;
-}
-//utility function
-static void setBitValue(byte* byteArray, size_t n, bool value) {
-    size_t byteIndex = n / 8;
-    size_t bitIndex = n % 8;
+//bitboard of a 2D or 3D grid: one bit per cell, rows padded to 32 bit words so 32 cells are processed per operation
+struct LifeBoard {
+  uint32_t *words;
+  Coord3D size;
+  uint16_t wordsPerRow;
+
+  LifeBoard(uint32_t *words, const Coord3D &size) {
+    this->words = words;
+    this->size = size;
+    wordsPerRow = (size.x + 31) / 32;
+  }
+
+  static size_t nrOfWords(const Coord3D &size) {return (size.x + 31) / 32 * size.y * size.z;}
+  size_t nrOfWords() const {return nrOfWords(size);}
+
+  uint32_t *row(int y, int z) const {return words + (y + z * size.y) * wordsPerRow;}
+  bool get(int x, int y, int z) const {return (row(y, z)[x >> 5] >> (x & 31)) & 1;}
+  void set(int x, int y, int z, bool value) {
     if (value)
-        byteArray[byteIndex] |= (1 << bitIndex);
+      row(y, z)[x >> 5] |= 1u << (x & 31);
     else
-        byteArray[byteIndex] &= ~(1 << bitIndex);
-}
+      row(y, z)[x >> 5] &= ~(1u << (x & 31));
+  }
+
+  //clear all cells which are not set in mask (e.g. cells without a led)
+  void mask(const LifeBoard &mask) {
+    for (size_t w = 0; w < nrOfWords(); w++) words[w] &= mask.words[w];
+  }
+
+  //add one bit per cell to a bit sliced counter (5 bits: up to 31 neighbors)
+  static void addBits(uint32_t *counter, uint32_t bits) {
+    for (int b = 0; b < 5 && bits; b++) {
+      uint32_t carry = counter[b] & bits;
+      counter[b] ^= bits;
+      bits = carry;
+    }
+  }
+
+  //next generation into next. birth / survive: bit n set if n neighbors give birth / survive
+  //wrap: x and y wrap around (2D), is3D: count neighbors in z as well, scratch: 2 * nrOfWords()
+  void step(LifeBoard &next, uint32_t birth, uint32_t survive, bool wrap, bool is3D, uint32_t *scratch) const {
+    const size_t boardWords = nrOfWords();
+    uint32_t *left = scratch; //left[x] = cell x-1
+    uint32_t *right = scratch + boardWords; //right[x] = cell x+1
+    const int lastWord = (size.x - 1) >> 5;
+    const int lastBit = (size.x - 1) & 31;
+    const uint32_t lastMask = (lastBit == 31)? UINT32_MAX: (2u << lastBit) - 1; //valid cells in the last word of a row
+
+    //shifted rows, once per generation
+    for (int z = 0; z < size.z; z++) for (int y = 0; y < size.y; y++) {
+      const uint32_t *r = row(y, z);
+      size_t offset = r - words;
+      for (int w = 0; w < wordsPerRow; w++) {
+        left[offset + w] = (r[w] << 1) | ((w > 0)? r[w - 1] >> 31: 0);
+        right[offset + w] = (r[w] >> 1) | ((w + 1 < wordsPerRow)? r[w + 1] << 31: 0);
+      }
+      left[offset + lastWord] &= lastMask;
+      if (wrap) {
+        left[offset] |= (r[lastWord] >> lastBit) & 1;
+        right[offset + lastWord] |= (r[0] & 1) << lastBit;
+      }
+    }
+
+    const uint32_t rules = birth | survive;
+    const int zAxis = is3D?1:0;
+    for (int z = 0; z < size.z; z++) for (int y = 0; y < size.y; y++) {
+      const uint32_t *alive = row(y, z);
+      uint32_t *result = next.row(y, z);
+      for (int w = 0; w < wordsPerRow; w++) {
+        uint32_t counter[5] = {0, 0, 0, 0, 0};
+        for (int k = -zAxis; k <= zAxis; k++) {
+          int nz = z + k;
+          if (nz < 0 || nz >= size.z) continue; //no wrap in z
+          for (int j = -1; j <= 1; j++) {
+            int ny = y + j;
+            if (ny < 0 || ny >= size.y) {
+              if (!wrap) continue;
+              ny = (ny + size.y) % size.y;
+            }
+            size_t offset = (ny + nz * size.y) * wordsPerRow + w;
+            addBits(counter, left[offset]);
+            addBits(counter, right[offset]);
+            if (j != 0 || k != 0) addBits(counter, words[offset]); //not itself
+          }
+        }
+        //apply the rules on all 32 cells at once
+        uint32_t nextWord = 0;
+        for (int n = 0; n < 32; n++) {
+          if (!((rules >> n) & 1)) continue;
+          uint32_t match = UINT32_MAX; //cells with n neighbors
+          for (int b = 0; b < 5; b++) match &= ((n >> b) & 1)? counter[b]: ~counter[b];
+          if ((birth >> n) & 1) nextWord |= match & ~alive[w];
+          if ((survive >> n) & 1) nextWord |= match & alive[w];
+        }
+        result[w] = (w == lastWord)? nextWord & lastMask: nextWord;
+      }
+    }
+  }
+};
 
 // Written by Ewoud Wijma in 2022, inspired by https://natureofcode.com/book/chapter-7-cellular-automata/ and https://github.com/DougHaber/nlife-color ,
 // Modified By: Brandon Butler in 2024
@@ -1572,7 +1678,7 @@ class GameOfLifeEffect: public Effect {
   uint8_t dim() override {return _3D;} //supports 3D but also 2D (1D as well?)
   const char * tags() override {return "💫";}
 
-  void placePentomino(LedsLayer &leds, byte *futureCells, bool colorByAge) {
+  void placePentomino(LedsLayer &leds, LifeBoard &futureCells, bool colorByAge) {
     byte pattern[5][2] = {{1, 0}, {0, 1}, {1, 1}, {2, 1}, {2, 2}}; // R-pentomino
     if (!random8(5)) pattern[0][1] = 3; // 1/5 chance to use glider
     CRGB color = ColorFromPalette(leds.palette, random8());
@@ -1584,13 +1690,13 @@ class GameOfLifeEffect: public Effect {
       for (int i = 0; i < 5; i++) {
         int nx = x + pattern[i][0];
         int ny = y + pattern[i][1];
-        if (getBitValue(futureCells, leds.XYZUnprojected({nx, ny, z}))) {canPlace = false; break;}
+        if (futureCells.get(nx, ny, z)) {canPlace = false; break;}
       }
       if (canPlace || attempts == 99) {
         for (int i = 0; i < 5; i++) {
           int nx = x + pattern[i][0];
           int ny = y + pattern[i][1];
-          setBitValue(futureCells, leds.XYZUnprojected({nx, ny, z}), true);
+          futureCells.set(nx, ny, z, true);
           leds.setPixelColor({nx, ny, z}, colorByAge ? CRGB::Green : color);
         }
         return;
@@ -1631,6 +1737,7 @@ class GameOfLifeEffect: public Effect {
     ui->initCheckBox(parentVar, "colorByAge",          leds.effectData.write<bool3State>(false));
     ui->initCheckBox(parentVar, "infinite",              leds.effectData.write<bool3State>(false));
     ui->initSlider  (parentVar, "blur",                  leds.effectData.write<uint8_t>(128), 0, 255);
+    ui->initSlider  (parentVar, "generations",           leds.effectData.write<uint8_t>(1), 1, 8); //per step
   }
 
   void loop(LedsLayer &leds) override {
@@ -1648,9 +1755,11 @@ class GameOfLifeEffect: public Effect {
     bool3State colorByAge   = leds.effectData.read<bool3State>();
     bool3State infinite     = leds.effectData.read<bool3State>();
     uint8_t blur            = leds.effectData.read<uint8_t>();
+    uint8_t generations     = leds.effectData.read<uint8_t>();
 
     // Effect Variables
-    const uint16_t dataSize = ((leds.size.x * leds.size.y * leds.size.z + 7) / 8);
+    const size_t boardWords = LifeBoard::nrOfWords(leds.size);
+    const uint16_t dataSize = boardWords * sizeof(uint32_t);
     unsigned long *step        = leds.effectData.readWrite<unsigned long>();
     uint16_t *gliderLength     = leds.effectData.readWrite<uint16_t>();
     uint16_t *cubeGliderLength = leds.effectData.readWrite<uint16_t>();
@@ -1659,13 +1768,19 @@ class GameOfLifeEffect: public Effect {
     uint16_t *cubeGliderCRC    = leds.effectData.readWrite<uint16_t>();
     bool3State     *soloGlider       = leds.effectData.readWrite<bool3State>();
     uint16_t *generation       = leds.effectData.readWrite<uint16_t>();
-    bool3State     *birthNumbers     = leds.effectData.readWrite<bool3State>(9);
-    bool3State     *surviveNumbers   = leds.effectData.readWrite<bool3State>(9);
+    uint32_t *birthNumbers     = leds.effectData.readWrite<uint32_t>(); //bit n: birth with n neighbors
+    uint32_t *surviveNumbers   = leds.effectData.readWrite<uint32_t>();
     CRGB     *prevPalette      = leds.effectData.readWrite<CRGB>();
-    byte     *cells            = leds.effectData.readWrite<byte>(dataSize);
-    byte     *futureCells      = leds.effectData.readWrite<byte>(dataSize);
+    uint32_t *cellWords        = leds.effectData.readWrite<uint32_t>(boardWords);
+    uint32_t *futureWords      = leds.effectData.readWrite<uint32_t>(boardWords);
+    uint32_t *mappedWords      = leds.effectData.readWrite<uint32_t>(boardWords); //cells with a led (3D)
+    uint32_t *scratchWords     = leds.effectData.readWrite<uint32_t>(boardWords * 3); //shifted rows and in between generations
     byte     *cellColors       = leds.effectData.readWrite<byte>(leds.size.x * leds.size.y * leds.size.z);
 
+    LifeBoard cells(cellWords, leds.size);
+    LifeBoard futureCells(futureWords, leds.size);
+    LifeBoard mappedCells(mappedWords, leds.size);
+
     CRGB bgColor = CRGB(bgC.x, bgC.y, bgC.z);
     CRGB color   = ColorFromPalette(leds.palette, random8()); // Used if all parents died
 
@@ -1677,24 +1792,26 @@ class GameOfLifeEffect: public Effect {
       disablePause ? *step = sys->now : *step = sys->now + 1500;
 
       // Setup Grid
-      memset(cells, 0, dataSize);
+      memset(cellWords, 0, dataSize);
+      memset(mappedWords, 0, dataSize);
       memset(cellColors, 0, leds.size.x * leds.size.y * leds.size.z);
 
       for (int x = 0; x < leds.size.x; x++) for (int y = 0; y < leds.size.y; y++) for (int z = 0; z < leds.size.z; z++){
         if (leds.projectionDimension == _3D && !leds.isMapped(leds.XYZUnprojected({x,y,z}))) continue;
+        mappedCells.set(x, y, z, true);
         if (random8(100) < lifeChance) {
           int index = leds.XYZUnprojected({x,y,z});
-          setBitValue(cells, index, true);
+          cells.set(x, y, z, true);
           cellColors[index] = random8(1, 255);
           leds.setPixelColor({x,y,z}, colorByAge ? CRGB::Green : ColorFromPalette(leds.palette, cellColors[index]));
           // leds.setPixelColor({x,y,z}, bgColor); // Color set in redraw loop
         }
       }
-      memcpy(futureCells, cells, dataSize);
+      memcpy(futureWords, cellWords, dataSize);
 
       *soloGlider = false;
       // Change CRCs
-      uint16_t crc = crc16((const unsigned char*)cells, dataSize);
+      uint16_t crc = crc16((const unsigned char*)cellWords, dataSize);
       *oscillatorCRC = crc, *spaceshipCRC = crc, *cubeGliderCRC = crc;
       *gliderLength  = lcm(leds.size.y, leds.size.x) * 4;
       *cubeGliderLength = *gliderLength * 6; // Change later for rectangular cuboid
@@ -1713,7 +1830,7 @@ class GameOfLifeEffect: public Effect {
         uint16_t cIndex = leds.XYZUnprojected(x,y,z); // Current cell index (bit grid lookup)
         uint16_t cLoc   = leds.XYZ(x,y,z);            // Current cell location (led index)
         if (!leds.isMapped(cIndex)) continue;
-        bool alive = getBitValue(cells, cIndex);
+        bool alive = cells.get(x, y, z);
         bool recolor = (alive && *generation == 1 && cellColors[cIndex] == 0 && !random(16)); // Palette change or Initial Color
         // Redraw alive if palette changed, spawn initial colors randomly, age alive cells while paused
         if      (alive && recolor) {
@@ -1744,16 +1861,16 @@ class GameOfLifeEffect: public Effect {
       else if (ruleset == 5) ruleString = "B3/S1234";       //Mazecentric
       else if (ruleset == 6) ruleString = "B367/S23";       //DrighLife
 
-      memset(birthNumbers,   0, sizeof(bool) * 9);
-      memset(surviveNumbers, 0, sizeof(bool) * 9);
+      *birthNumbers   = 0;
+      *surviveNumbers = 0;
 
       //Rule String Parsing
       int slashIndex = ruleString.indexOf('/');
       for (int i = 0; i < ruleString.length(); i++) {
         int num = ruleString.charAt(i) - '0';
         if (num >= 0 && num < 9) {
-          if (i < slashIndex) birthNumbers[num] = true;
-          else surviveNumbers[num] = true;
+          if (i < slashIndex) *birthNumbers |= 1u << num;
+          else *surviveNumbers |= 1u << num;
         }
       }
     }
@@ -1761,44 +1878,50 @@ class GameOfLifeEffect: public Effect {
     int aliveCount = 0, deadCount = 0; // Detect solo gliders and dead grids
     const int zAxis  = (leds.projectionDimension == _3D) ? 1 : 0; // Avoids looping through z axis neighbors if 2D
     bool disableWrap = !wrap || *soloGlider || *generation % 1500 == 0 || zAxis;
-    //Loop through all cells. Count neighbors, apply rules, setPixel
+    //Next generation(s) of all cells at once, 32 cells per operation
+    uint32_t *shifted = scratchWords;
+    LifeBoard between(scratchWords + 2 * boardWords, leds.size);
+    //on 3D fixtures no cells are born in voxels without a led, also not in between generations
+    cells.step(futureCells, *birthNumbers, *surviveNumbers, !disableWrap, zAxis, shifted);
+    if (zAxis) futureCells.mask(mappedCells);
+    for (int g = 1; g < generations; g++) {
+      memcpy(between.words, futureWords, dataSize);
+      between.step(futureCells, *birthNumbers, *surviveNumbers, !disableWrap, zAxis, shifted);
+      if (zAxis) futureCells.mask(mappedCells);
+    }
+    //Loop through all cells. Colors of born cells, setPixel
     for (int x = 0; x < leds.size.x; x++) for (int y = 0; y < leds.size.y; y++) for (int z = 0; z < leds.size.z; z++){
       Coord3D  cPos      = {x, y, z};
       uint16_t cIndex    = leds.XYZUnprojected(cPos);
-      bool     cellValue = getBitValue(cells, cIndex);
+      bool     cellValue = cells.get(x, y, z);
       if (cellValue) aliveCount++; else deadCount++;
-      if (zAxis && !leds.isMapped(cIndex)) continue; // Skip if not physical led on 3D fixtures
-      byte neighbors = 0, colorCount = 0;
-      byte nColors[9];
-
-      for (int i = -1; i <= 1; i++) for (int j = -1; j <= 1; j++) for (int k = -zAxis; k <= zAxis; k++) {
-        if (i==0 && j==0 && k==0) continue; // Ignore itself
-        Coord3D nPos = {x+i, y+j, z+k};
-        if (nPos.isOutofBounds(leds.size)) {
-          // Wrap is disabled when unchecked, for 3D fixtures, every 1500 generations, and solo gliders
-          if (disableWrap) continue;
-          nPos = (nPos + leds.size) % leds.size; // Wrap around 3D
-        }
-        uint16_t nIndex = leds.XYZUnprojected(nPos);
-        // Count neighbors and store up to 9 neighbor colors
-        if (getBitValue(cells, nIndex)) {
-          neighbors++;
-          if (cellValue || colorByAge) continue; // Skip if cell is alive (color already set) or color by age (colors are not used)
-          if (cellColors[nIndex] == 0) continue; // Skip if neighbor color is 0 (dead cell)
-          nColors[colorCount % 9] = cellColors[nIndex];
-          colorCount++;
-        }
-      }
-      // Rules of Life
-      if (cellValue && !surviveNumbers[neighbors]) {
+      if (zAxis && !leds.isMapped(cIndex)) continue; // Skip if not physical led on 3D fixtures (masked in futureCells)
+      bool futureValue = futureCells.get(x, y, z);
+
+      if (cellValue && !futureValue) {
         // Loneliness or Overpopulation
-        setBitValue(futureCells, cIndex, false);
         leds.blendPixelColor(cPos, bgColor, blur);
       }
-      else if (!cellValue && birthNumbers[neighbors]){
-        // Reproduction
-        setBitValue(futureCells, cIndex, true);
-        byte colorIndex = nColors[random8(colorCount)];
+      else if (!cellValue && futureValue) {
+        // Reproduction, color of one of the neighbors
+        byte colorCount = 0;
+        byte nColors[9];
+        if (!colorByAge) {
+          for (int i = -1; i <= 1; i++) for (int j = -1; j <= 1; j++) for (int k = -zAxis; k <= zAxis; k++) {
+            if (i==0 && j==0 && k==0) continue; // Ignore itself
+            Coord3D nPos = {x+i, y+j, z+k};
+            if (nPos.isOutofBounds(leds.size)) {
+              // Wrap is disabled when unchecked, for 3D fixtures, every 1500 generations, and solo gliders
+              if (disableWrap) continue;
+              nPos = (nPos + leds.size) % leds.size; // Wrap around 3D
+            }
+            uint16_t nIndex = leds.XYZUnprojected(nPos);
+            if (!cells.get(nPos.x, nPos.y, nPos.z) || cellColors[nIndex] == 0) continue; // Skip dead cells
+            nColors[colorCount % 9] = cellColors[nIndex];
+            colorCount++;
+          }
+        }
+        byte colorIndex = colorCount ? nColors[random8(colorCount < 9 ? colorCount : 9)] : random8();
         if (random8(100) < mutation) colorIndex = random8();
         cellColors[cIndex] = colorIndex;
         leds.setPixelColor(cPos, colorByAge ? CRGB::Green : ColorFromPalette(leds.palette, colorIndex));
@@ -1820,14 +1943,15 @@ class GameOfLifeEffect: public Effect {
     }
 
     if (aliveCount == 5) *soloGlider = true; else *soloGlider = false;
-    memcpy(cells, futureCells, dataSize);
-    uint16_t crc = crc16((const unsigned char*)cells, dataSize);
+    memcpy(cellWords, futureWords, dataSize);
+    uint16_t crc = crc16((const unsigned char*)cellWords, dataSize);
 
     bool repetition = false;
     if (!aliveCount || crc == *oscillatorCRC || crc == *spaceshipCRC || crc == *cubeGliderCRC) repetition = true;
     if ((repetition && infinite) || (infinite && !random8(50)) || (infinite && float(aliveCount)/(aliveCount + deadCount) < 0.05)) {
       placePentomino(leds, futureCells, colorByAge); // Place R-pentomino/Glider if infinite mode is enabled
-      memcpy(cells, futureCells, dataSize);
+      if (zAxis) futureCells.mask(mappedCells);
+      memcpy(cellWords, futureWords, dataSize);
       repetition = false;
     }
     if (repetition) {
@@ -2136,108 +2260,6 @@ class ParticleTestEffect: public Effect {
   uint8_t     dim() override {return _3D;}
   const char * tags() override {return "💫🧭";}
   
-  struct Particle {
-    float x, y, z;
-    float vx, vy, vz;
-    CRGB color;
-
-    void update() {
-      x += vx;
-      y += vy;
-      z += vz;
-    }
-    void revert() {
-      x -= vx;
-      y -= vy;
-      z -= vz;
-    }
-
-    Coord3D toCoord3DRounded() {
-      return Coord3D({int(round(x)), int(round(y)), int(round(z))});
-    }
-
-    void updatePositionandDraw(LedsLayer &leds, int particleIndex = 0, bool debugPrint = false) {
-      if (debugPrint) ppf("Particle %d: Pos: %f, %f, %f Velocity: %f, %f, %f\n", particleIndex, x, y, z, vx, vy, vz);
-
-      Coord3D prevPos = toCoord3DRounded();
-      if (debugPrint) ppf("     PrevPos: %d, %d, %d\n", prevPos.x, prevPos.y, prevPos.z);
-      
-      update();
-      Coord3D newPos = toCoord3DRounded();
-      if (debugPrint) ppf("     NewPos: %d, %d, %d\n", newPos.x, newPos.y, newPos.z);
-
-      if (newPos == prevPos) return; // Skip if no change in position
-
-      leds.setPixelColor(prevPos, CRGB::Black); // Clear previous position
-
-      if (leds.isMapped(leds.XYZUnprojected(newPos)) && !newPos.isOutofBounds(leds.size) && leds.getPixelColor(newPos) == CRGB::Black) {
-        if (debugPrint) ppf("     New Pos was mapped and particle placed\n");
-        leds.setPixelColor(newPos, color); // Set new position
-        return;
-      }
-      
-      // Particle is not mapped, find nearest mapped pixel
-      Coord3D nearestMapped = prevPos;                          // Set nearest to previous position
-      unsigned nearestDist = newPos.distanceSquared(prevPos);   // Set distance to previous position
-      int diff = 0;                                             // If distance the same check how many coordinates are different (larger is better)
-      bool changed = false;
-
-      if (debugPrint) ppf("     %d, %d, %d, Not Mapped! Nearest: %d, %d, %d dist: %d diff: %d\n", newPos.x, newPos.y, newPos.z, nearestMapped.x, nearestMapped.y, nearestMapped.z, nearestDist, diff);
-      
-      // Check neighbors for nearest mapped pixel. This should be changed to check neighbors with similar velocity
-      for (int i = -1; i <= 1; i++) for (int j = -1; j <= 1; j++) for (int k = -1; k <= 1; k++) {
-        Coord3D testPos = newPos + Coord3D({i, j, k});
-        if (testPos == prevPos)                         continue; // Skip current position
-        if (!leds.isMapped(leds.XYZUnprojected(testPos)))    continue; // Skip if not mapped
-        if (testPos.isOutofBounds(leds.size))           continue; // Skip out of bounds
-        if (leds.getPixelColor(testPos) != CRGB::Black) continue; // Skip if already colored by another particle
-        unsigned dist = testPos.distanceSquared(newPos);
-        int differences = (prevPos.x != testPos.x) + (prevPos.y != testPos.y) + (prevPos.z != testPos.z);
-        if (debugPrint) ppf ("     TestPos: %d %d %d Dist: %d Diff: %d", testPos.x, testPos.y, testPos.z, dist, differences);
-        if (debugPrint) ppf ("     New Velocities: %d, %d, %d\n", (testPos.x - prevPos.x), (testPos.y - prevPos.y), (testPos.z - prevPos.z));
-        if (dist < nearestDist || (dist == nearestDist && differences >= diff)) {
-          nearestDist = dist;
-          nearestMapped = testPos;
-          diff = differences;
-          changed = true;
-        }
-      }
-      if (changed) { // Change velocity to move towards nearest mapped pixel. Update position.
-        if (newPos.x != nearestMapped.x) vx = constrain(nearestMapped.x - prevPos.x, -1, 1);
-        if (newPos.y != nearestMapped.y) vy = constrain(nearestMapped.y - prevPos.y, -1, 1);
-        if (newPos.z != nearestMapped.z) vz = constrain(nearestMapped.z - prevPos.z, -1, 1);
-
-        x = nearestMapped.x; 
-        y = nearestMapped.y; 
-        z = nearestMapped.z;
-        
-        if (debugPrint) ppf("     New Position: %d, %d, %d New Velocity: %f, %f, %f\n", nearestMapped.x, nearestMapped.y, nearestMapped.z, vx, vy, vz);
-      }
-      else {
-        // No valid position found, revert to previous position
-        // Find which direction is causing OoB / not mapped and set velocity to 0
-        Coord3D testing = toCoord3DRounded();
-        revert();
-        // change X val
-        testing.x = newPos.x;
-        if (testing.isOutofBounds(leds.size) || !leds.isMapped(leds.XYZUnprojected(testing))) vx = 0;
-        // change Y val
-        testing = toCoord3DRounded();
-        testing.y = newPos.y;
-        if (testing.isOutofBounds(leds.size) || !leds.isMapped(leds.XYZUnprojected(testing))) vy = 0;
-        // change Z val
-        testing = toCoord3DRounded();
-        testing.z = newPos.z;
-        if (testing.isOutofBounds(leds.size) || !leds.isMapped(leds.XYZUnprojected(testing))) vz = 0;
-        
-        if (debugPrint) ppf("     No valid position found, reverted. Velocity Updated\n");
-        if (debugPrint) ppf("     New Pos: %f, %f, %f Velo: %f, %f, %f\n", x, y, z, vx, vy, vz);
-      }
-
-      leds.setPixelColor(toCoord3DRounded(), color);
-    }
-  };
-
   void setup(LedsLayer &leds, Variable parentVar) override {
     Effect::setup(leds, parentVar);
     bool3State *setup = leds.effectData.write<bool3State>(true);
@@ -2271,19 +2293,19 @@ class ParticleTestEffect: public Effect {
     #endif
     bool3State randomGravity = leds.effectData.read<bool3State>();
     uint8_t gravityChangeInterval = leds.effectData.read<uint8_t>();
-    // bool3State debugPrint    = leds.effectData.read<bool3State>();
-    bool debugPrint = false;
 
     // Effect Variables
-    Particle *particles       = leds.effectData.readWrite<Particle>(255);
     unsigned long *step       = leds.effectData.readWrite<unsigned long>();
     unsigned long *gravUpdate = leds.effectData.readWrite<unsigned long>();
     float *gravity = leds.effectData.readWrite<float>(3);
+    Particles particles;
+    if (!particles.bind(leds, 255, true)) return; //with occupancy grid for collisions
 
     if (*setup) {
       ppf("Setting Up Particles\n");
       *setup = false;
       leds.fill_solid(CRGB::Black);
+      particles.clear(leds);
 
       if (barriers) {
         // create a 2 pixel thick barrier around middle y value with gaps
@@ -2291,30 +2313,24 @@ class ParticleTestEffect: public Effect {
           if (!random8(5)) continue;
           leds.setPixelColor({x, leds.size.y/2, z}, CRGB::White);
           leds.setPixelColor({x, leds.size.y/2 - 1, z}, CRGB::White);
+          particles.setOccupied(leds, {x, leds.size.y/2, z}, true);
+          particles.setOccupied(leds, {x, leds.size.y/2 - 1, z}, true);
         }
       }
 
       for (int index = 0 ; index < numParticles; index++) {
         Coord3D rPos; 
         int attempts = 0; 
-        do { // Get random mapped position that isn't colored (infinite loop if small fixture size and high particle count)
+        do { // Get random mapped position that isn't occupied (infinite loop if small fixture size and high particle count)
           rPos = {random8(leds.size.x), random8(leds.size.y), random8(leds.size.z)};
           attempts++;
-        } while ((!leds.isMapped(leds.XYZUnprojected(rPos)) || leds.getPixelColor(rPos) != CRGB::Black) && attempts < 1000);
-        // rPos = {1,1,0};
-        particles[index].x = rPos.x;
-        particles[index].y = rPos.y;
-        particles[index].z = rPos.z;
-
-        particles[index].vx = (random8() / 256.0f) * 2.0f - 1.0f;
-        particles[index].vy = (random8() / 256.0f) * 2.0f - 1.0f;
-        if (leds.projectionDimension == _3D) particles[index].vz = (random8() / 256.0f) * 2.0f - 1.0f;
-        else particles[index].vz = 0;
+        } while (!particles.isFree(leds, rPos) && attempts < 1000);
 
-        particles[index].color = ColorFromPalette(leds.palette, random8());
-        Coord3D initPos = particles[index].toCoord3DRounded();
-        leds.setPixelColor(initPos, particles[index].color);
+        int32_t vz = (leds.projectionDimension == _3D)? (random8() * 2 - 256) * 256: 0; // -1 .. 1 pixel per step
+        particles.add(rPos.x * Particles::one, rPos.y * Particles::one, rPos.z * Particles::one, (random8() * 2 - 256) * 256, (random8() * 2 - 256) * 256, vz, random8());
+        particles.setOccupied(leds, rPos, true);
       }
+      particles.render(leds);
       ppf("Particles Set Up\n");
       *step = sys->now;
     }
@@ -2354,15 +2370,10 @@ class ParticleTestEffect: public Effect {
       }
     }
 
-    for (int index = 0; index < numParticles; index++) {
-      if (gyro || randomGravity) { // Lerp gravity towards gyro or random gravity if enabled
-        float lerpFactor = .75;
-        particles[index].vx += (gravity[0] - particles[index].vx) * lerpFactor;
-        particles[index].vy += (gravity[1] - particles[index].vy) * lerpFactor; // Swap Y and Z axis
-        particles[index].vz += (gravity[2] - particles[index].vz) * lerpFactor;
-      }
-      particles[index].updatePositionandDraw(leds, index, debugPrint);  
-    }
+    if (gyro || randomGravity) // Lerp gravity towards gyro or random gravity if enabled
+      particles.steer(gravity[0] * Particles::one, gravity[1] * Particles::one, gravity[2] * Particles::one, 192); // lerpFactor .75
+    particles.collide(leds);
+    particles.render(leds);
 
     *step = sys->now;
   }
@@ -2373,11 +2384,6 @@ class StarFieldEffect: public Effect {  // Inspired by Daniel Shiffman's Coding
   uint8_t     dim() override {return _2D;}
   const char * tags() override {return "💫";}
 
-  struct Star {
-    int x, y, z;
-    uint8_t colorIndex;
-  };
-
   static float fmap(const float x, const float in_min, const float in_max, const float out_min, const float out_max) {
     return (out_max - out_min) * (x - in_min) / (in_max - in_min) + out_min;
   }
@@ -2401,51 +2407,51 @@ class StarFieldEffect: public Effect {  // Inspired by Daniel Shiffman's Coding
 
     // Effect Variables
     unsigned long *step = leds.effectData.readWrite<unsigned long>();
-    Star *stars         = leds.effectData.readWrite<Star>(255);
-
+    Particles stars; //x, y in -size .. size, z is the distance, moving towards the viewer 1 per update
+    if (!stars.bind(leds, 255)) return;
+    const int32_t one = Particles::one;
 
     if (*setup) {
       *setup = false; 
       leds.fill_solid(CRGB::Black);
-      //set up all stars
-      for (int i = 0; i < 255; i++) {
-        stars[i].x = random(-leds.size.x, leds.size.x);
-        stars[i].y = random(-leds.size.y, leds.size.y);
-        stars[i].z = random(leds.size.x);
-        stars[i].colorIndex = random8();
-      }
+      stars.clear(leds);
     }
+    //set up new stars
+    while (*stars.count < numStars)
+      stars.add(random(-leds.size.x, leds.size.x) * one, random(-leds.size.y, leds.size.y) * one, random(leds.size.x) * one, 0, 0, -one, random8());
+    while (*stars.count > numStars) stars.remove(*stars.count - 1);
 
     if (!speed || sys->now - *step < 1000 / speed) return; // Not enough time passed
 
     leds.fadeToBlackBy(blur);
 
-    for (int i = 0; i < numStars; i++) {
-      //update star
-      // ppf("Star %d Pos: %d, %d, %d -> ", i, stars[i].x, stars[i].y, stars[i].z);
-      float sx = leds.size.x/2.0 + fmap(float(stars[i].x) / stars[i].z, 0, 1, 0, leds.size.x/2.0);
-      float sy = leds.size.y/2.0 + fmap(float(stars[i].y) / stars[i].z, 0, 1, 0, leds.size.y/2.0);
+    for (int i = 0; i < *stars.count; i++) {
+      //project star
+      int x = stars.pos[0][i] / one, y = stars.pos[1][i] / one, z = stars.pos[2][i] / one;
+      // ppf("Star %d Pos: %d, %d, %d -> ", i, x, y, z);
+      float sx = leds.size.x/2.0 + fmap(float(x) / z, 0, 1, 0, leds.size.x/2.0);
+      float sy = leds.size.y/2.0 + fmap(float(y) / z, 0, 1, 0, leds.size.y/2.0);
 
       // ppf(" %f, %f\n", sx, sy);
 
       Coord3D pos = {int(sx), int(sy), 0};
       if (!pos.isOutofBounds(leds.size)) {
-        if (usePalette) leds.setPixelColor(sx, sy, ColorFromPalette(leds.palette, stars[i].colorIndex, map(stars[i].z, 0, leds.size.x, 255, 150)));
+        if (usePalette) leds.setPixelColor(sx, sy, ColorFromPalette(leds.palette, stars.colorIndex[i], map(z, 0, leds.size.x, 255, 150)));
         else {
-          uint8_t color = map(stars[i].colorIndex, 0, 255, 120, 255);
-          int brightness = map(stars[i].z, 0, leds.size.x, 7, 10);
+          uint8_t color = map(stars.colorIndex[i], 0, 255, 120, 255);
+          int brightness = map(z, 0, leds.size.x, 7, 10);
           color *= brightness/10.0;
           leds.setPixelColor(sx, sy, CRGB(color, color, color));
         }
       }
-      stars[i].z -= 1;
-      if (stars[i].z <= 0 || pos.isOutofBounds(leds.size)) {
-        stars[i].x = random(-leds.size.x, leds.size.x);
-        stars[i].y = random(-leds.size.y, leds.size.y);
-        stars[i].z = leds.size.x;
-        stars[i].colorIndex = random8();
+      if (z <= 1 || pos.isOutofBounds(leds.size)) { //z <= 0 after this update
+        stars.pos[0][i] = random(-leds.size.x, leds.size.x) * one;
+        stars.pos[1][i] = random(-leds.size.y, leds.size.y) * one;
+        stars.pos[2][i] = (leds.size.x + 1) * one; //size.x after this update
+        stars.colorIndex[i] = random8();
       }
     }
+    stars.integrate(); //all stars move towards the viewer
 
     *step = sys->now;
   }
@@ -2532,8 +2538,10 @@ class WaverlyEffect: public Effect {
 
     long t = sys->now / 2; 
     Coord3D pos = {0,0,0}; //initialize z otherwise wrong results
+    uint8_t *noise = leds.spanIndexBuffer(leds.size.x);
+    inoise8Row(noise, leds.size.x, 0, 45, t, t);
     for (pos.x = 0; pos.x < leds.size.x; pos.x++) {
-      uint16_t thisVal = audioSync->sync.volumeSmth * amplification * inoise8(pos.x * 45 , t , t) / 4096;      // WLEDMM back to SR code
+      uint16_t thisVal = audioSync->sync.volumeSmth * amplification * noise[pos.x] / 4096;      // WLEDMM back to SR code
       uint16_t thisMax = min(map(thisVal, 0, 512, 0, leds.size.y), (long)leds.size.y);
 
       for (pos.y = 0; pos.y < thisMax; pos.y++) {
@@ -2575,6 +2583,44 @@ class GEQEffect: public Effect {
     // #endif
   }
 
+  //per column band and color, per row color and bar height per fft value: no float and map() per frame
+  struct Tables {
+    uint8_t *band, *nextBand, *columnColor, *rowColor;
+    uint16_t *barHeight;
+    bool bind(LedsLayer &leds) {
+      leds.effectCache.begin();
+      band = leds.effectCache.readWrite<uint8_t>(leds.size.x);
+      nextBand = leds.effectCache.readWrite<uint8_t>(leds.size.x);
+      columnColor = leds.effectCache.readWrite<uint8_t>(leds.size.x);
+      rowColor = leds.effectCache.readWrite<uint8_t>(leds.size.y);
+      barHeight = leds.effectCache.readWrite<uint16_t>(256);
+      return leds.effectCache.success();
+    }
+  };
+
+  void resize(LedsLayer &leds) override {
+    Tables tables;
+    if (!tables.bind(leds)) return;
+    const int NUM_BANDS = NUM_GEQ_CHANNELS ; // map(leds.custom1, 0, 255, 1, 16);
+
+    //evenly distribute see also Funky Plank/By ewowi/From AXI
+    float bandwidth = (float)leds.size.x / NUM_BANDS;
+    float remaining = bandwidth;
+    uint8_t band = 0;
+    for (int x = 0; x < leds.size.x; x++) {
+      //WLEDMM if not enough remaining
+      if (remaining < 1) {band++; remaining+= bandwidth;} //increase remaining but keep the current remaining
+      remaining--; //consume remaining
+      tables.band[x] = ((NUM_BANDS < 16) && (NUM_BANDS > 1)) ? map(band, 0, NUM_BANDS - 1, 0, 15):band; // always use full range. comment out this line to get the previous behaviour.
+      uint8_t nextband = (remaining < 1)? band +1: band;
+      nextband = constrain(nextband, 0, 15);  // just to be sure
+      tables.nextBand[x] = ((NUM_BANDS < 16) && (NUM_BANDS > 1)) ? map(nextband, 0, NUM_BANDS - 1, 0, 15):nextband;
+      tables.columnColor[x] = map(x, 0, leds.size.x-1, 0, 255); //WLEDMM
+    }
+    for (int y = 0; y < leds.size.y; y++) tables.rowColor[y] = map(y, 0, leds.size.y-1, 0, 255);
+    for (int i = 0; i < 256; i++) tables.barHeight[i] = map(i, 0, 255, 0, leds.size.y); // do not subtract -1 from leds.size.y here
+  }
+
   void loop(LedsLayer &leds) override {
     //Binding of controls. Keep before binding of vars and keep in same order as in setup()
     uint8_t fadeOut = leds.effectData.read<uint8_t>();
@@ -2586,7 +2632,8 @@ class GEQEffect: public Effect {
     uint16_t *previousBarHeight = leds.effectData.readWrite<uint16_t>(leds.size.x); //array
     unsigned long *step = leds.effectData.readWrite<unsigned long>();
 
-    const int NUM_BANDS = NUM_GEQ_CHANNELS ; // map(leds.custom1, 0, 255, 1, 16);
+    Tables tables;
+    if (!tables.bind(leds)) return;
 
     #ifdef SR_DEBUG
     uint8_t samplePeak = *(uint8_t*)um_data->u_data[3];
@@ -2605,36 +2652,24 @@ class GEQEffect: public Effect {
 
     uint16_t lastBandHeight = 0;  // WLEDMM: for smoothing out bars
 
-    //evenly distribute see also Funky Plank/By ewowi/From AXI
-    float bandwidth = (float)leds.size.x / NUM_BANDS;
-    float remaining = bandwidth;
-    uint8_t band = 0;
     Coord3D pos = {0,0,0};
     for (pos.x=0; pos.x < leds.size.x; pos.x++) {
-      //WLEDMM if not enough remaining
-      if (remaining < 1) {band++; remaining+= bandwidth;} //increase remaining but keep the current remaining
-      remaining--; //consume remaining
-
-      // ppf("x %d b %d n %d w %f %f\n", x, band, NUM_BANDS, bandwidth, remaining);
-      uint8_t frBand = ((NUM_BANDS < 16) && (NUM_BANDS > 1)) ? map(band, 0, NUM_BANDS - 1, 0, 15):band; // always use full range. comment out this line to get the previous behaviour.
-      // frBand = constrain(frBand, 0, 15); //WLEDMM can never be out of bounds (I think...)
+      uint8_t frBand = tables.band[pos.x]; //see resize
       uint16_t colorIndex = frBand * 17; //WLEDMM 0.255
       uint16_t bandHeight = audioSync->fftResults[frBand];  // WLEDMM we use the original ffResult, to preserve accuracy
 
       // WLEDMM begin - smooth out bars
       if ((pos.x > 0) && (pos.x < (leds.size.x-1)) && (smoothBars)) {
         // get height of next (right side) bar
-        uint8_t nextband = (remaining < 1)? band +1: band;
-        nextband = constrain(nextband, 0, 15);  // just to be sure
-        frBand = ((NUM_BANDS < 16) && (NUM_BANDS > 1)) ? map(nextband, 0, NUM_BANDS - 1, 0, 15):nextband; // always use full range. comment out this line to get the previous behaviour.
+        frBand = tables.nextBand[pos.x];
         uint16_t nextBandHeight = audioSync->fftResults[frBand];
         // smooth Band height
         bandHeight = (7*bandHeight + 3*lastBandHeight + 3*nextBandHeight) / 12;   // yeees, its 12 not 13 (10% amplification)
         bandHeight = constrain(bandHeight, 0, 255);   // remove potential over/underflows
-        colorIndex = map(pos.x, 0, leds.size.x-1, 0, 255); //WLEDMM
+        colorIndex = tables.columnColor[pos.x]; //WLEDMM
       }
       lastBandHeight = bandHeight; // remember BandHeight (left side) for next iteration
-      uint16_t barHeight = map(bandHeight, 0, 255, 0, leds.size.y); // Now we map bandHeight to barHeight. do not subtract -1 from leds.size.y here
+      uint16_t barHeight = tables.barHeight[bandHeight]; // Now we map bandHeight to barHeight
       // WLEDMM end
 
       if (barHeight > leds.size.y) barHeight = leds.size.y;                      // WLEDMM map() can "overshoot" due to rounding errors
@@ -2644,7 +2679,7 @@ class GEQEffect: public Effect {
 
       for (pos.y=0; pos.y < barHeight; pos.y++) {
         if (colorBars) //color_vertical / color bars toggle
-          colorIndex = map(pos.y, 0, leds.size.y-1, 0, 255);
+          colorIndex = tables.rowColor[pos.y];
 
         ledColor = ColorFromPalette(leds.palette, (uint8_t)colorIndex);
 
@@ -2881,7 +2916,7 @@ class PaintbrushEffect: public Effect {
         else
           color = ColorFromPalette(leds.palette, map(i, 0, numLines, 0, 255), 255);
         if (leds.projectionDimension == _3D)
-          leds.drawLine3D(x1, y1, z1, x2, y2, z2, color, soft, length); // no soft implemented in 3D yet
+          leds.drawLine3D(x1, y1, z1, x2, y2, z2, color, soft, length);
         else
           leds.drawLine(x1, y1, x2, y2, color, soft, length);
       }
@@ -2919,20 +2954,14 @@ class FireworksEffect: public Effect {
 
     float *dying_gravity = leds.effectData.readWrite<float>();
     uint16_t *aux0Flare = leds.effectData.readWrite<uint16_t>();
-    Spark* sparks = leds.effectData.readWrite<Spark>(255);
-    Spark* flare = sparks; //first spark is flare data
+    Particles sparks; //x, y, first particle is the flare, life is the brightness
+    if (!sparks.bind(leds, 255)) return;
+    const uint8_t flare = 0;
+    const int32_t one = Particles::one;
 
     const uint16_t cols = leds.size.x;
     const uint16_t rows = leds.size.y;
 
-    //allocate segment data
-
-    // if (dataSize != SEGENV.aux1) { //reset to flare if sparks were reallocated (it may be good idea to reset segment if bounds change)
-    //   *dying_gravity = 0.0f;
-    //   (*aux0Flare) = 0;
-    //   SEGENV.aux1 = dataSize;
-    // }
-
     leds.fadeToBlackBy(252); //fade_out(252);
 
     float gravity = -0.0004f - (gravityC/800000.0f); // m/s/s
@@ -2940,26 +2969,23 @@ class FireworksEffect: public Effect {
 
     if ((*aux0Flare) < 2) { //FLARE
       if ((*aux0Flare) == 0) { //init flare
-        flare->pos = 0;
-        flare->posX = random16(2,cols-3);
+        sparks.clear(leds);
         uint16_t peakHeight = 75 + random8(180); //0-255
         peakHeight = (peakHeight * (rows -1)) >> 8;
-        flare->vel = sqrtf(-2.0f * gravity * peakHeight);
-        flare->velX = (random8(9)-4)/32.f;
-        flare->col = 255; //brightness
+        sparks.add(random16(2,cols-3) * one, 0, 0, (random8(9)-4) * one / 32, sqrtf(-2.0f * gravity * peakHeight) * one, 0, 0, 255); //white, full brightness
         (*aux0Flare) = 1;
       }
 
       // launch
-      if (flare->vel > 12 * gravity) {
+      if (sparks.vel[1][flare] > 12 * gravity * one) {
         // flare
-        leds.setPixelColor(int(flare->posX), rows - uint16_t(flare->pos) - 1, CRGB(flare->col, flare->col, flare->col));
-        flare->pos  += flare->vel;
-        flare->posX += flare->velX;
-        flare->pos  = constrain(flare->pos, 0, rows-1);
-        flare->posX = constrain(flare->posX, 0, cols-1);
-        flare->vel  += gravity;
-        flare->col  -= 2;
+        uint8_t brightness = sparks.life[flare];
+        leds.setPixelColor(sparks.pos[0][flare] >> 16, rows - (sparks.pos[1][flare] >> 16) - 1, CRGB(brightness, brightness, brightness));
+        sparks.integrate();
+        sparks.pos[1][flare] = constrain(sparks.pos[1][flare], 0, (rows-1) * one);
+        sparks.pos[0][flare] = constrain(sparks.pos[0][flare], 0, (cols-1) * one);
+        sparks.accelerate(0, gravity * one, 0);
+        sparks.life[flare] -= 2;
       } else {
         (*aux0Flare) = 2;  // ready to explode
       }
@@ -2970,43 +2996,34 @@ class FireworksEffect: public Effect {
       * Explosion happens where the flare ended.
       * Size is proportional to the height.
       */
-      uint8_t nSparks = flare->pos + random8(4);
-      // nSparks = std::max(nSparks, 4U);  // This is not a standard constrain; numSparks is not guaranteed to be at least 4
-      nSparks = std::min(nSparks, numSparks);
 
       // initialize sparks
       if ((*aux0Flare) == 2) {
+        uint8_t nSparks = (sparks.pos[1][flare] >> 16) + random8(4);
+        // nSparks = std::max(nSparks, 4U);  // This is not a standard constrain; numSparks is not guaranteed to be at least 4
+        nSparks = std::min(nSparks, numSparks);
+        float heightFactor = float(sparks.pos[1][flare]) / one / rows; // proportional to height
+        float widthFactor = float(sparks.pos[0][flare]) / one / cols; // proportional to width
         for (int i = 1; i < nSparks; i++) {
-          sparks[i].pos  = flare->pos;
-          sparks[i].posX = flare->posX;
-          sparks[i].vel  = (float(random16(20001)) / 10000.0f) - 0.9f; // from -0.9 to 1.1
+          float vel  = (float(random16(20001)) / 10000.0f) - 0.9f; // from -0.9 to 1.1
+          float velX = (float(random16(20001)) / 10000.0f) - 0.9f; // from -0.9 to 1.1
           // sparks[i].vel *= rows<32 ? 0.5f : 1; // reduce velocity for smaller strips
-          sparks[i].velX  = (float(random16(20001)) / 10000.0f) - 0.9f; // from -0.9 to 1.1
-          // sparks[i].velX = (float(random16(10001)) / 10000.0f) - 0.5f; // from -0.5 to 0.5
-          sparks[i].col  = 345;//abs(sparks[i].vel * 750.0); // set colors before scaling velocity to keep them bright
-          //sparks[i].col = constrain(sparks[i].col, 0, 345);
-          sparks[i].colIndex = random8();
-          sparks[i].vel  *= flare->pos/rows; // proportional to height
-          sparks[i].velX *= flare->posX/cols; // proportional to width
-          sparks[i].vel  *= -gravity *50;
+          sparks.add(sparks.pos[0][flare], sparks.pos[1][flare], 0, velX * widthFactor * one, vel * heightFactor * -gravity * 50 * one, 0, random8(), 345); // set colors before scaling velocity to keep them bright
         }
-        //sparks[1].col = 345; // this will be our known spark
         *dying_gravity = gravity/2;
         (*aux0Flare) = 3;
       }
 
-      if (sparks[1].col > 4) {//&& sparks[1].pos > 0) { // as long as our known spark is lit, work with all the sparks
-        for (int i = 1; i < nSparks; i++) {
-          sparks[i].pos  += sparks[i].vel;
-          sparks[i].posX += sparks[i].velX;
-          sparks[i].vel  += *dying_gravity;
-          sparks[i].velX += *dying_gravity;
-          if (sparks[i].col > 3) sparks[i].col -= 4;
-
-          if (sparks[i].pos > 0 && sparks[i].pos < rows) {
-            if (!(sparks[i].posX >= 0 && sparks[i].posX < cols)) continue;
-            uint16_t prog = sparks[i].col;
-            CRGB spColor = ColorFromPalette(leds.palette, sparks[i].colIndex);
+      if (*sparks.count > 1 && sparks.life[1] > 4) { // as long as our known spark is lit, work with all the sparks
+        sparks.integrate(); //the flare is not drawn anymore
+        sparks.accelerate(*dying_gravity * one, *dying_gravity * one, 0);
+        for (int i = 1; i < *sparks.count; i++) {
+          if (sparks.life[i] > 3) sparks.life[i] -= 4;
+
+          if (sparks.pos[1][i] > 0 && sparks.pos[1][i] < rows * one) {
+            if (!(sparks.pos[0][i] >= 0 && sparks.pos[0][i] < cols * one)) continue;
+            uint16_t prog = sparks.life[i];
+            CRGB spColor = ColorFromPalette(leds.palette, sparks.colorIndex[i]);
             CRGB c = CRGB::Black; //HeatColor(sparks[i].col);
             if (prog > 300) { //fade from white to spark color
               c = CRGB(blend(spColor, CRGB::White, (prog - 300)*5));
@@ -3016,7 +3033,7 @@ class FireworksEffect: public Effect {
               c.g = qsub8(c.g, cooling);
               c.b = qsub8(c.b, cooling * 2);
             }
-            leds.setPixelColor(sparks[i].posX, rows - sparks[i].pos - 1, c);
+            leds.setPixelColor(sparks.pos[0][i] >> 16, (rows * one - sparks.pos[1][i] - one) >> 16, c);
           }
         }
         leds.blur2d(16);
@@ -3154,11 +3171,14 @@ class RipplesEffect: public Effect {
 
     leds.fill_solid(CRGB::Black);
 
+    //distance to the middle of the xz plane
+    const RadialField &field = leds.radial(Coord3D{leds.size.x, 0, leds.size.z}, Coord3D{leds.size.x, 1, leds.size.z});
+
     Coord3D pos = {0,0,0};
     for (pos.z=0; pos.z<leds.size.z; pos.z++) {
       for (pos.x=0; pos.x<leds.size.x; pos.x++) {
 
-        float d = distance(leds.size.x/2.0f, leds.size.z/2.0f, 0.0f, (float)pos.x, (float)pos.z, 0.0f) / 9.899495f * leds.size.y;
+        float d = field.distance(Coord3D{pos.x, 0, pos.z}) / 9.899495f * leds.size.y;
         pos.y = floor(leds.size.y/2.0f * (1 + sinf(d/ripple_interval + time_interval))); //between 0 and leds.size.y
 
         leds[pos] = CHSV( sys->now/50 + random8(64), 200, 255);// ColorFromPalette(leds.palette,call, bri);
@@ -3190,14 +3210,18 @@ class SphereMoveEffect: public Effect {
     origin.z = leds.size.z / 2.0 * ( 1.0 + cosf(time_interval));
 
     float diameter = 2.0f+sinf(time_interval/3.0f);
+    //compare squared distances, no sqrt per pixel
+    float inner = diameter * diameter;
+    float outer = (diameter + 1.0f) * (diameter + 1.0f);
 
     Coord3D pos;
     for (pos.x=0; pos.x<leds.size.x; pos.x++) {
         for (pos.y=0; pos.y<leds.size.y; pos.y++) {
             for (pos.z=0; pos.z<leds.size.z; pos.z++) {
-                float d = distance(pos.x, pos.y, pos.z, origin.x, origin.y, origin.z);
+                Coord3D delta = pos - origin;
+                int d2 = delta.x * delta.x + delta.y * delta.y + delta.z * delta.z;
 
-                if (d>diameter && d<diameter + 1.0) {
+                if (d2>inner && d2<outer) {
                   leds[pos] = CHSV( sys->now/50 + random8(64), 200, 255);// ColorFromPalette(leds.palette,call, bri);
                 }
             }
@@ -3270,9 +3294,7 @@ class MarioTestEffect: public Effect {
     if (background) leds.fill_solid(CRGB::DimGrey);
     else leds.fill_solid(CRGB::Black);
     //draw 16x16 mario
-    for (int x = 0; x < 16; x++) for (int y = 0; y < 16; y++) {
-      leds[Coord3D({x + offsetX, y + offsetY, 0})] = colors[mario[y][x]];
-    }
+    leds.blitSprite(&mario[0][0], 16, 16, colors, offsetX, offsetY);
   }
 }; // MarioTest
 
@@ -3295,6 +3317,12 @@ class MarioTestEffect: public Effect {
   static void _fadeToBlackBy(uint8_t fadeBy) {if (gLeds) gLeds->fadeToBlackBy(fadeBy);}
   static void sPCLive(uint16_t pixel, CRGB color) {if (gLeds) gLeds->setPixelColor(pixel, color);} //setPixelColor with color
   static void sCFPLive(uint16_t pixel, uint8_t index, uint8_t brightness) {if (gLeds) gLeds->setPixelColor(pixel, ColorFromPalette(gLeds->palette, index, brightness));} //setPixelColor within palette
+  static void noiseRowLive(uint16_t y, uint16_t scale, uint16_t z) { //row y in palette colors of noise(x * scale, y * scale, z)
+    if (!gLeds || y >= gLeds->size.y) return;
+    uint8_t *row = gLeds->spanIndexBuffer(gLeds->size.x);
+    inoise8Row(row, gLeds->size.x, 0, scale, y * scale, z);
+    gLeds->writeRowPal(y, row);
+  }
 
   //WLED nostalgia
   uint8_t speedControl = 128;
@@ -3355,6 +3383,7 @@ class LiveEffect: public Effect {
                 liveM->addExternalFun("uint8_t", "cos8", "(uint8_t a1)",(void*)_cos8); //using int here causes value must be between 0 and 16 error!!!
                 liveM->addExternalFun("void", "sPC", "(uint16_t a1, CRGB a2)", (void *)sPCLive);
                 liveM->addExternalFun("void", "sCFP", "(uint16_t a1, uint8_t a2, uint8_t a3)", (void *)sCFPLive);
+                liveM->addExternalFun("void", "noiseRow", "(uint16_t a1, uint16_t a2, uint16_t a3)", (void *)noiseRowLive);
                 liveM->addExternalFun("void", "fadeToBlackBy", "(uint8_t a1)", (void *)_fadeToBlackBy);
 
                 //WLED nostalgia
@@ -11,6 +11,7 @@
 
 #include "LedLayer.h"
 #include "LedModFixture.h"
+#include <algorithm>
 
 #include "../Sys/SysModSystem.h"  //for sys->now
 #include "../Sys/SysModFiles.h"
@@ -74,7 +75,8 @@ void Effect::setup(LedsLayer &leds, Variable parentVar) {
     }});
 }
 
-void PhysMap::addIndexP(LedsLayer &leds, uint16_t indexP) {
+template <typename T>
+void PhysMapT<T>::addIndexP(LedsLayer &leds, uint16_t indexP) {
   // ppf("addIndexP i:%d t:%d", indexP, mapType);
   switch (mapType) {
     case m_color:
@@ -145,71 +147,364 @@ int LedsLayer::XYZ(Coord3D pixel) {
   return XYZUnprojected(pixel);
 }
 
+void LedsLayer::physicalPixels(std::vector<uint16_t> &indexesP) const {
+  indexesP.clear();
+  if (!projection) {
+    for (uint16_t indexP = 0; indexP < fix->nrOfLeds; indexP++) indexesP.push_back(indexP);
+    return;
+  }
+  for (uint16_t indexV = 0; indexV < mappingTableSizeUsed; indexV++) {
+    if (wideMapping)
+      addMappedIndexesP(mappingTableWide[indexV], indexesP);
+    else
+      addMappedIndexesP(mappingTable[indexV], indexesP);
+  }
+  //fan-out layers can have a physical pixel in more than one mapping entry: keep each physical pixel once, else add / screen are applied twice
+  std::sort(indexesP.begin(), indexesP.end());
+  indexesP.erase(std::unique(indexesP.begin(), indexesP.end()), indexesP.end());
+}
+
+template <typename PhysMapT>
+void LedsLayer::addMappedIndexesP(const PhysMapT &physMap, std::vector<uint16_t> &indexesP) const {
+  switch (physMap.mapType) {
+    case m_onePixel:
+      indexesP.push_back(physMap.indexP);
+      break;
+    case m_morePixels:
+      for (uint16_t indexP: mappingTableIndexes[physMap.indexes]) indexesP.push_back(indexP);
+      break;
+    default: ;
+  }
+}
+
+bool LedsLayer::restoreLayerPixels() {
+  if (ledsPal) return false; //palette mode: ledsPal are the layer pixels
+  if (!ledsL) { //first frame after mapping: take over what is in ledsP
+    physicalPixels(indexesP);
+    ledsL = (CRGB *)malloc(indexesP.size() * sizeof(CRGB));
+    if (!ledsL) {
+      ppf("restoreLayerPixels malloc failed %d\n", indexesP.size() * sizeof(CRGB));
+      indexesP.clear();
+      return false;
+    }
+    storeLayerPixels();
+    return true;
+  }
+  for (size_t i = 0; i < indexesP.size(); i++) fix->ledsP[indexesP[i]] = ledsL[i];
+  return true;
+}
+
+void LedsLayer::storeLayerPixels() {
+  for (size_t i = 0; i < indexesP.size(); i++) ledsL[i] = fix->ledsP[indexesP[i]];
+}
+
+void LedsLayer::releaseLayerPixels() {
+  free(ledsL);
+  ledsL = nullptr;
+  indexesP.clear();
+  indexesP.shrink_to_fit();
+}
+
+//one pixel of composite, for layers without ledsL
+static void compositePixel(CRGB &ledP, CRGB color, uint8_t blendMode, uint8_t opacity) {
+  switch (blendMode) {
+    case bm_add:
+      ledP += color.nscale8_video(opacity);
+      break;
+    case bm_multiply:
+      ledP = blend(ledP, ledP.scale8(color), opacity);
+      break;
+    case bm_screen:
+      ledP = blend(ledP, -(-ledP).scale8(-color), opacity);
+      break;
+    case bm_max:
+      ledP = blend(ledP, ledP | color, opacity);
+      break;
+    default: //bm_alpha
+      ledP = opacity == 255?color:blend(ledP, color, opacity);
+  }
+}
+
+void LedsLayer::composite() {
+  if (ledsPal) {
+    resolvePalettePixels();
+    return;
+  }
+  if (!ledsL) return;
+  CRGB *ledsP = fix->ledsP;
+  const size_t nrOfPixels = indexesP.size();
+  //mode switch outside the pixel loop so each loop is tight
+  switch (blendMode) {
+    case bm_add:
+      for (size_t i = 0; i < nrOfPixels; i++) {
+        CRGB color = ledsL[i];
+        ledsP[indexesP[i]] += color.nscale8_video(opacity);
+      }
+      break;
+    case bm_multiply:
+      for (size_t i = 0; i < nrOfPixels; i++) {
+        CRGB &ledP = ledsP[indexesP[i]];
+        ledP = blend(ledP, ledP.scale8(ledsL[i]), opacity);
+      }
+      break;
+    case bm_screen:
+      for (size_t i = 0; i < nrOfPixels; i++) {
+        CRGB &ledP = ledsP[indexesP[i]];
+        ledP = blend(ledP, -(-ledP).scale8(-ledsL[i]), opacity); //255 - (255-a)*(255-b)/255
+      }
+      break;
+    case bm_max:
+      for (size_t i = 0; i < nrOfPixels; i++) {
+        CRGB &ledP = ledsP[indexesP[i]];
+        ledP = blend(ledP, ledP | ledsL[i], opacity); //| is max per channel
+      }
+      break;
+    default: //bm_alpha
+      if (opacity == 255)
+        for (size_t i = 0; i < nrOfPixels; i++) ledsP[indexesP[i]] = ledsL[i];
+      else
+        for (size_t i = 0; i < nrOfPixels; i++) ledsP[indexesP[i]] = blend(ledsP[indexesP[i]], ledsL[i], opacity);
+  }
+}
+
+template <typename PhysMapT>
+void LedsLayer::setMappedColor(PhysMapT &physMap, const CRGB& color) {
+  switch (physMap.mapType) {
+    case m_color:
+      if (ledsV)
+        ledsV[physMap.rgb] = color;
+      else
+        physMap.setRGB(color);
+      break;
+    case m_onePixel:
+      fix->ledsP[physMap.indexP] = color;
+      break;
+    case m_morePixels:
+      if (physMap.indexes < mappingTableIndexes.size())
+        for (uint16_t indexP: mappingTableIndexes[physMap.indexes]) {
+          fix->ledsP[indexP] = color;
+        }
+      else
+        ppf("dev setPixelColor m:%d s:%d\n", physMap.indexes, mappingTableIndexes.size());
+      break;
+    default: ;
+  }
+}
+
 // maps the virtual led to the physical led(s) and assign a color to it
-void LedsLayer::setPixelColor(const int indexV, const CRGB& color) {
+void LedsLayer::writePixelColor(const int indexV, const CRGB& color) {
   if (indexV < 0)
     return;
   else if (indexV < mappingTableSizeUsed) {
-    switch (mappingTable[indexV].mapType) {
-      case m_color:{
-        mappingTable[indexV].rgb14 = ((min(color.r + 3, 255) >> 3) << 9) + 
-                                     ((min(color.g + 3, 255) >> 3) << 4) + 
-                                      (min(color.b + 7, 255) >> 4);
-        break;
-      }
-      case m_onePixel: {
-        uint16_t indexP = mappingTable[indexV].indexP;
-        fix->ledsP[indexP] = fix->pixelsToBlend[indexP]?blend(color, fix->ledsP[indexP], fix->globalBlend):color;
-        break; }
-      case m_morePixels:
-        if (mappingTable[indexV].indexes < mappingTableIndexes.size())
-          for (uint16_t indexP: mappingTableIndexes[mappingTable[indexV].indexes]) {
-            fix->ledsP[indexP] = fix->pixelsToBlend[indexP]?blend(color, fix->ledsP[indexP], fix->globalBlend): color;
-          }
-        else
-          ppf("dev setPixelColor i:%d m:%d s:%d\n", indexV, mappingTable[indexV].indexes, mappingTableIndexes.size());
-        break;
-      default: ;
-    }
+    if (wideMapping)
+      setMappedColor(mappingTableWide[indexV], color);
+    else
+      setMappedColor(mappingTable[indexV], color);
   }
-  else if (indexV < STARLIGHT_MAXLEDS) //no projection
-    fix->ledsP[indexV] = fix->pixelsToBlend[indexV]?blend(color, fix->ledsP[indexV], fix->globalBlend): color;
+  else if (indexV < fix->nrOfLeds) //no projection
+    fix->ledsP[indexV] = color;
   // some operations will go out of bounds e.g. VUMeter, uncomment below lines if you wanna test on a specific effect
   // else //if (indexV != UINT16_MAX) //assuming UINT16_MAX is set explicitly (e.g. in XYZ)
-  //   ppf(" dev sPC %d >= %d", indexV, STARLIGHT_MAXLEDS);
+  //   ppf(" dev sPC %d >= %d", indexV, fix->nrOfLeds);
+}
+
+//specialized set and get, no mapType switch
+void LedsLayer::writePixelContiguous(const int indexV, const CRGB& color) {
+  if ((unsigned)indexV < contiguousSize) fix->ledsP[contiguousStart + indexV] = color;
+}
+void LedsLayer::writePixelOneToOne(const int indexV, const CRGB& color) {
+  if ((unsigned)indexV < mappingTableSizeUsed) fix->ledsP[mappingTable[indexV].indexP] = color;
+}
+void LedsLayer::writePixelOneToOneWide(const int indexV, const CRGB& color) {
+  if ((unsigned)indexV < mappingTableSizeUsed) fix->ledsP[mappingTableWide[indexV].indexP] = color;
+}
+CRGB LedsLayer::readPixelContiguous(const int indexV) const {
+  return (unsigned)indexV < contiguousSize?fix->ledsP[contiguousStart + indexV]:CRGB(CRGB::Black);
+}
+CRGB LedsLayer::readPixelOneToOne(const int indexV) const {
+  return (unsigned)indexV < mappingTableSizeUsed?fix->ledsP[mappingTable[indexV].indexP]:CRGB(CRGB::Black);
+}
+CRGB LedsLayer::readPixelOneToOneWide(const int indexV) const {
+  return (unsigned)indexV < mappingTableSizeUsed?fix->ledsP[mappingTableWide[indexV].indexP]:CRGB(CRGB::Black);
+}
+
+//palette mode: the pixel keeps its palette index, the brightness follows the color (so fades and black work)
+void LedsLayer::writePixelPal(const int indexV, const CRGB& color) {
+  if ((unsigned)indexV >= nrOfLedsPal) return;
+  PalPixel &palPixel = ledsPal[indexV];
+  const CRGB &palColor = paletteLUT[palPixel.index];
+  uint8_t bri = max(color.r, max(color.g, color.b));
+  uint8_t palBri = max(palColor.r, max(palColor.g, palColor.b));
+  palPixel.bri = bri < palBri?bri * 255 / palBri:bri?255:0;
+}
+CRGB LedsLayer::readPixelPal(const int indexV) const {
+  if ((unsigned)indexV >= nrOfLedsPal) return CRGB::Black;
+  CRGB color = paletteLUT[ledsPal[indexV].index];
+  return color.nscale8(ledsPal[indexV].bri);
+}
+
+void RadialField::build(const Coord3D &size, const Coord3D &center2) {
+  this->size = size;
+  this->center2 = center2;
+  polar.resize(size.x * size.y * size.z);
+  uint32_t i = 0;
+  for (int z = 0; z < size.z; z++) {
+    for (int y = 0; y < size.y; y++) {
+      for (int x = 0; x < size.x; x++) {
+        //in half pixels
+        int dx = 2 * x - center2.x;
+        int dy = 2 * y - center2.y;
+        int dz = 2 * z - center2.z;
+        float distance = sqrtf(dx * dx + dy * dy + dz * dz) * 8; //1/16 pixels
+        polar[i].distance = distance < UINT16_MAX?distance:UINT16_MAX;
+        polar[i].angle = (int32_t)(atan2f(dy, dx) * 32768.0f / PI);
+        i++;
+      }
+    }
+  }
+}
+
+const RadialField &LedsLayer::radial(const Coord3D &center2, const Coord3D &fieldSize, uint8_t user) {
+  RadialField *victim = nullptr;
+  for (RadialField &field: radialFields) {
+    if (field.size == fieldSize && field.center2 == center2 && field.polar.size()) {
+      field.users |= user;
+      field.lastUsed = sys->now;
+      return field;
+    }
+    //prefer empty, then unreferenced, then only used by this user, least recently used first
+    if (!victim) {victim = &field; continue;}
+    uint8_t rank = field.polar.empty()?0:!field.users?1:field.users == user?2:3;
+    uint8_t victimRank = victim->polar.empty()?0:!victim->users?1:victim->users == user?2:3;
+    if (rank < victimRank || (rank == victimRank && field.lastUsed < victim->lastUsed)) victim = &field;
+  }
+  if (victim->users & ~user) ppf("radial all fields in use, rebuilding one of another user\n");
+  victim->build(fieldSize, center2);
+  victim->users = user;
+  victim->lastUsed = sys->now;
+  return *victim;
+}
+
+void LedsLayer::writeSpan(int indexV, const CRGB *colors, uint16_t count) {
+  if (indexV < 0) {
+    if (-indexV >= count) return;
+    colors -= indexV; count += indexV; indexV = 0;
+  }
+  const int nrOfVirtual = projection?mappingTableSizeUsed:fix->nrOfLeds;
+  if (indexV >= nrOfVirtual) return;
+  if (indexV + count > nrOfVirtual) count = nrOfVirtual - indexV;
+
+  if (mapShape == ms_contiguous && !ledsPal) {
+    if (indexV >= contiguousSize) return;
+    if (indexV + count > contiguousSize) count = contiguousSize - indexV;
+    memcpy((void *)(fix->ledsP + contiguousStart + indexV), colors, count * sizeof(CRGB));
+  }
+  else
+    for (uint16_t i = 0; i < count; i++) (this->*writePixelColorCached)(indexV + i, colors[i]);
+}
+
+void LedsLayer::writeSpanPal(int indexV, const uint8_t *palIndexes, uint16_t count) {
+  if (ledsPal) {
+    for (uint16_t i = 0; i < count; i++)
+      if (indexV + i >= 0 && indexV + i < nrOfLedsPal) ledsPal[indexV + i] = {palIndexes[i], 255};
+  }
+  else {
+    CRGB *colors = spanBuffer(count);
+    for (uint16_t i = 0; i < count; i++) colors[i] = ColorFromPalette(palette, palIndexes[i]);
+    writeSpan(indexV, colors, count);
+  }
+}
+
+void LedsLayer::writeRow(int y, const CRGB *colors, int z) {
+  if (y < 0 || y >= size.y || z < 0 || z >= size.z) return;
+  if (projection && projection->hasXYZ())
+    for (int x = 0; x < size.x; x++) setPixelColor(Coord3D{x, y, z}, colors[x]);
+  else
+    writeSpan(XYZUnprojected(0, y, z), colors, size.x);
+}
+
+void LedsLayer::writeRowPal(int y, const uint8_t *palIndexes, int z) {
+  if (y < 0 || y >= size.y || z < 0 || z >= size.z) return;
+  if (projection && projection->hasXYZ())
+    for (int x = 0; x < size.x; x++) setPixelColorPal(Coord3D{x, y, z}, palIndexes[x]);
+  else
+    writeSpanPal(XYZUnprojected(0, y, z), palIndexes, size.x);
+}
+
+void LedsLayer::writeColumn(int x, const CRGB *colors, int z) {
+  if (x < 0 || x >= size.x || z < 0 || z >= size.z) return;
+  if (projection && projection->hasXYZ())
+    for (int y = 0; y < size.y; y++) setPixelColor(Coord3D{x, y, z}, colors[y]);
+  else { //strided: mapping shape resolved once for the column
+    int indexV = XYZUnprojected(x, 0, z);
+    if (mapShape == ms_contiguous && !ledsPal) {
+      CRGB *ledsP = fix->ledsP + contiguousStart;
+      for (int y = 0; y < size.y; y++, indexV += size.x)
+        if ((unsigned)indexV < contiguousSize) ledsP[indexV] = colors[y];
+    }
+    else {
+      void (LedsLayer::*writePixel)(int, const CRGB&) = writePixelColorCached;
+      for (int y = 0; y < size.y; y++, indexV += size.x) (this->*writePixel)(indexV, colors[y]);
+    }
+  }
+}
+
+void LedsLayer::writeBlock3D(const Coord3D &from, const Coord3D &to, const CRGB *colors) {
+  const int width = to.x - from.x + 1;
+  if (width <= 0) return;
+  const bool perPixel = projection && projection->hasXYZ();
+  for (int z = from.z; z <= to.z; z++) {
+    for (int y = from.y; y <= to.y; y++) {
+      if (y >= 0 && y < size.y && z >= 0 && z < size.z) {
+        if (perPixel)
+          for (int x = from.x; x <= to.x; x++) setPixelColor(Coord3D{x, y, z}, colors[x - from.x]);
+        else {
+          //clip the row to the layer
+          int x0 = max(from.x, 0);
+          int x1 = min(to.x, size.x - 1);
+          if (x0 <= x1) writeSpan(XYZUnprojected(x0, y, z), colors + (x0 - from.x), x1 - x0 + 1);
+        }
+      }
+      colors += width;
+    }
+  }
 }
 
 void LedsLayer::setPixelColorPal(const int indexV, uint8_t palIndex, uint8_t palBri) {
-  setPixelColor(indexV, ColorFromPalette(palette, palIndex, palBri));
+  if (ledsPal) {
+    if ((unsigned)indexV < nrOfLedsPal) ledsPal[indexV] = {palIndex, palBri};
+  }
+  else
+    setPixelColor(indexV, ColorFromPalette(palette, palIndex, palBri));
 }
 
 void LedsLayer::blendPixelColor(const int indexV, const CRGB& color, uint8_t blendAmount) {
   setPixelColor(indexV, blend(color, getPixelColor(indexV), blendAmount));
 }
 
-CRGB LedsLayer::getPixelColor(const int indexV) const {
+template <typename PhysMapT>
+CRGB LedsLayer::getMappedColor(const PhysMapT &physMap) const {
+  switch (physMap.mapType) {
+    case m_onePixel:
+      return fix->ledsP[physMap.indexP]; 
+    case m_morePixels:
+      return fix->ledsP[mappingTableIndexes[physMap.indexes][0]]; //any would do as they are all the same
+    default: // m_color:
+      return ledsV?ledsV[physMap.rgb]:physMap.getRGB();
+  }
+}
+
+CRGB LedsLayer::readPixelColor(const int indexV) const {
   if (indexV < 0)
     return CRGB::Black;
   else if (indexV < mappingTableSizeUsed) {
-    switch (mappingTable[indexV].mapType) {
-      case m_onePixel:
-        return fix->ledsP[mappingTable[indexV].indexP]; 
-        break;
-      case m_morePixels:
-        return fix->ledsP[mappingTableIndexes[mappingTable[indexV].indexes][0]]; //any would do as they are all the same
-        break;
-      default: // m_color:
-        return CRGB((mappingTable[indexV].rgb14 >> 9) << 3, 
-                    (mappingTable[indexV].rgb14 >> 4) << 3, 
-                     mappingTable[indexV].rgb14       << 4);
-        break;
-    }
+    return wideMapping?getMappedColor(mappingTableWide[indexV]):getMappedColor(mappingTable[indexV]);
   }
-  else if (indexV < STARLIGHT_MAXLEDS) //no mapping
+  else if (indexV < fix->nrOfLeds) //no mapping
     return fix->ledsP[indexV];
   else {
     // some operations will go out of bounds e.g. VUMeter, uncomment below lines if you wanna test on a specific effect
-    // ppf(" dev gPC %d >= %d", indexV, STARLIGHT_MAXLEDS);
+    // ppf(" dev gPC %d >= %d", indexV, fix->nrOfLeds);
     return CRGB::Black;
   }
 }
@@ -223,8 +518,13 @@ void LedsLayer::fadeToBlackBy(const uint8_t fadeBy) {
         setPixelColor({x,y,0}, color);
       }
     }
-  } else if (!projection || (fix->layers.size() == 1)) { //faster, else manual 
-    fastled_fadeToBlackBy(fix->ledsP, fix->nrOfLeds, fadeBy);
+  } else if (ledsPal) { //palette mode: only the brightness fades
+    for (uint16_t indexV = 0; indexV < nrOfLedsPal; indexV++) ledsPal[indexV].bri = scale8(ledsPal[indexV].bri, 255-fadeBy);
+  } else if (mapShape == ms_contiguous || !projection || (fix->layers.size() == 1)) { //faster, else manual 
+    if (mapShape == ms_contiguous)
+      fastled_fadeToBlackBy(fix->ledsP + contiguousStart, contiguousSize, fadeBy);
+    else
+      fastled_fadeToBlackBy(fix->ledsP, fix->nrOfLeds, fadeBy);
   } else {
     for (uint16_t index = 0; index < mappingTableSizeUsed; index++) {
       CRGB color = getPixelColor(index);
@@ -241,8 +541,13 @@ void LedsLayer::fill_solid(const CRGB& color) {
         setPixelColor({x,y,0}, color);
       }
     }
-  } else if (!projection || (fix->layers.size() == 1)) { //faster, else manual 
-    fastled_fill_solid(fix->ledsP, fix->nrOfLeds, color);
+  } else if (ledsPal) {
+    for (uint16_t indexV = 0; indexV < nrOfLedsPal; indexV++) writePixelPal(indexV, color);
+  } else if (mapShape == ms_contiguous || !projection || (fix->layers.size() == 1)) { //faster, else manual 
+    if (mapShape == ms_contiguous)
+      fastled_fill_solid(fix->ledsP + contiguousStart, contiguousSize, color);
+    else
+      fastled_fill_solid(fix->ledsP, fix->nrOfLeds, color);
   } else {
     for (uint16_t index = 0; index < mappingTableSizeUsed; index++)
       setPixelColor(index, color);
@@ -276,18 +581,51 @@ void LedsLayer::fill_rainbow(const uint8_t initialhue, const uint8_t deltahue) {
   }
 }
 
-  void LedsLayer::drawCharacter(unsigned char chr, int x, int y, uint8_t font, CRGB col, uint16_t shiftPixel, uint16_t shiftChr) {
-    if (chr < 32 || chr > 126) return; // only ASCII 32-126 supported
-    chr -= 32; // align with font table entries
+  Coord3D TextBitmap::fontSize(uint8_t font) {
+    switch (font%5) {
+      case 0: return Coord3D{4, 6, 1};
+      case 1: return Coord3D{5, 8, 1};
+      case 2: return Coord3D{5, 12, 1};
+      case 3: return Coord3D{6, 8, 1};
+      default: return Coord3D{7, 9, 1};
+    }
+  }
 
-    Coord3D fontSize;
+  uint8_t TextBitmap::fontRow(uint8_t font, unsigned char chr, uint8_t row) {
+    if (chr < 32 || chr > 126) return 0; // only ASCII 32-126 supported
+    chr -= 32; // align with font table entries
+    const int index = chr * fontSize(font).y + row;
     switch (font%5) {
-      case 0: fontSize.x = 4; fontSize.y = 6; break;
-      case 1: fontSize.x = 5; fontSize.y = 8; break;
-      case 2: fontSize.x = 5; fontSize.y = 12; break;
-      case 3: fontSize.x = 6; fontSize.y = 8; break;
-      case 4: fontSize.x = 7; fontSize.y = 9; break;
+      case 0: return pgm_read_byte_near(&console_font_4x6[index]);
+      case 1: return pgm_read_byte_near(&console_font_5x8[index]);
+      case 2: return pgm_read_byte_near(&console_font_5x12[index]);
+      case 3: return pgm_read_byte_near(&console_font_6x8[index]);
+      default: return pgm_read_byte_near(&console_font_7x9[index]);
     }
+  }
+
+  void TextBitmap::rasterize(const char *text, uint8_t font) {
+    this->text = text;
+    this->font = font;
+    const Coord3D glyph = fontSize(font);
+    const int numberOfChr = strnlen(text, 256); //max 256 charcters
+    resize(numberOfChr * glyph.x, glyph.y);
+    for (int chrNr = 0; chrNr < numberOfChr; chrNr++) {
+      const int column = chrNr * glyph.x;
+      for (int row = 0; row < glyph.y; row++) {
+        //glyph columns are the top bits of the font byte, shift them in at column
+        const uint8_t glyphBits = fontRow(font, text[chrNr], row) & (0xFF << (8 - glyph.x));
+        uint8_t *dest = &bits[row * rowBytes() + (column >> 3)];
+        dest[0] |= glyphBits >> (column & 7);
+        if ((column & 7) + glyph.x > 8) dest[1] |= glyphBits << (8 - (column & 7));
+      }
+    }
+  }
+
+  void LedsLayer::drawCharacter(unsigned char chr, int x, int y, uint8_t font, CRGB col, uint16_t shiftPixel, uint16_t shiftChr) {
+    if (chr < 32 || chr > 126) return; // only ASCII 32-126 supported
+
+    const Coord3D fontSize = TextBitmap::fontSize(font);
 
     Coord3D chrPixel;
     for (chrPixel.y = 0; chrPixel.y<fontSize.y; chrPixel.y++) { // character height
@@ -295,14 +633,7 @@ void LedsLayer::fill_rainbow(const uint8_t initialhue, const uint8_t deltahue) {
       pixel.z = 0;
       pixel.y = y + chrPixel.y;
       if (pixel.y >= 0 && pixel.y < size.y) {
-        byte bits = 0;
-        switch (font%5) {
-          case 0: bits = pgm_read_byte_near(&console_font_4x6[(chr * fontSize.y) + chrPixel.y]); break;
-          case 1: bits = pgm_read_byte_near(&console_font_5x8[(chr * fontSize.y) + chrPixel.y]); break;
-          case 2: bits = pgm_read_byte_near(&console_font_5x12[(chr * fontSize.y) + chrPixel.y]); break;
-          case 3: bits = pgm_read_byte_near(&console_font_6x8[(chr * fontSize.y) + chrPixel.y]); break;
-          case 4: bits = pgm_read_byte_near(&console_font_7x9[(chr * fontSize.y) + chrPixel.y]); break;
-        }
+        byte bits = TextBitmap::fontRow(font, chr, chrPixel.y);
 
         for (chrPixel.x = 0; chrPixel.x<fontSize.x; chrPixel.x++) {
           //x adjusted by: chr in text, scroll value, font column
@@ -315,9 +646,583 @@ void LedsLayer::fill_rainbow(const uint8_t initialhue, const uint8_t deltahue) {
     }
   }
 
+  void LedsLayer::drawText(const char * text, int x, int y, uint8_t font, CRGB col, uint16_t shiftPixel) {
+    if (!text) return;
+    //find the text in the glyph cache, else rasterize it in the least recently used entry
+    TextBitmap *textBitmap = &textBitmaps[0];
+    for (TextBitmap &cached: textBitmaps) {
+      if (cached.font == font && cached.text == text) {textBitmap = &cached; break;}
+      if (cached.lastUsed < textBitmap->lastUsed) textBitmap = &cached;
+    }
+    if (textBitmap->font != font || textBitmap->text != text) textBitmap->rasterize(text, font);
+    textBitmap->lastUsed = sys->now;
+
+    blit(*textBitmap, x + shiftPixel, y, col, 1, true);
+  }
+
+  void LedsLayer::blit(const Bitmap &bitmap, int x, int y, CRGB col, uint8_t scale, bool wrapX) {
+    if (!scale || !size.x) return;
+    const bool perPixel = projection && projection->hasXYZ();
+    CRGB *colors = nullptr;
+    if (!perPixel) {
+      colors = spanBuffer(size.x);
+      for (int i = 0; i < size.x; i++) colors[i] = col;
+    }
+
+    for (int row = 0; row < bitmap.height; row++) {
+      for (int column = 0; column < bitmap.width; column++) {
+        if (!bitmap.get(column, row)) continue;
+        //run of set bits
+        int runEnd = column + 1;
+        while (runEnd < bitmap.width && bitmap.get(runEnd, row)) runEnd++;
+
+        int from = x + column * scale;
+        int count = (runEnd - column) * scale;
+        column = runEnd;
+        if (wrapX) {
+          if (from < 0) {count += from; from = 0;} //left of the layer is not drawn
+          from %= size.x;
+        }
+        else {
+          if (from < 0) {count += from; from = 0;}
+          if (from + count > size.x) count = size.x - from;
+        }
+
+        while (count > 0) {
+          const int part = min(count, size.x - from); //until the right side of the layer, then wrap
+          for (int dy = 0; dy < scale; dy++) {
+            const int pixelY = y + row * scale + dy;
+            if (pixelY < 0 || pixelY >= size.y) continue;
+            if (perPixel)
+              for (int pixelX = from; pixelX < from + part; pixelX++) setPixelColor(Coord3D{pixelX, pixelY, 0}, col);
+            else
+              writeSpan(XYZUnprojected(from, pixelY, 0), colors, part);
+          }
+          count -= part;
+          from = 0;
+          if (!wrapX) break;
+        }
+      }
+    }
+  }
+
+  void LedsLayer::blitSprite(const uint8_t *indexes, int width, int height, const CRGB *colors, int x, int y, uint8_t transparent) {
+    CRGB *row = spanBuffer(width);
+    for (int spriteY = 0; spriteY < height; spriteY++, indexes += width) {
+      int runStart = -1;
+      for (int spriteX = 0; spriteX <= width; spriteX++) {
+        const bool drawn = spriteX < width && indexes[spriteX] != transparent;
+        if (drawn) {
+          row[spriteX] = colors[indexes[spriteX]];
+          if (runStart < 0) runStart = spriteX;
+        }
+        else if (runStart >= 0) { //end of a run of drawn pixels
+          writeBlock3D(Coord3D{x + runStart, y + spriteY, 0}, Coord3D{x + spriteX - 1, y + spriteY, 0}, row + runStart);
+          runStart = -1;
+        }
+      }
+    }
+  }
+
+  void LedsLayer::addFragment(int x, int y, int z, uint8_t coverage) {
+    if (!coverage) return;
+    Coord3D pixel = {x, y, z};
+    if (pixel.isOutofBounds(size)) return;
+    fragments.push_back({XYZ(pixel), coverage});
+  }
+
+  void LedsLayer::compositeFragments(const CRGB &color) {
+    CRGB *colors = nullptr;
+    for (size_t i = 0; i < fragments.size();) {
+      const Fragment &fragment = fragments[i];
+      if (fragment.coverage == 255) {
+        //run of consecutive virtual pixels
+        size_t run = 1;
+        while (i + run < fragments.size() && run < (size_t)size.x && fragments[i + run].coverage == 255 && fragments[i + run].indexV == fragment.indexV + (int)run) run++;
+        if (run > 1) {
+          if (!colors) {
+            colors = spanBuffer(size.x);
+            for (int x = 0; x < size.x; x++) colors[x] = color;
+          }
+          writeSpan(fragment.indexV, colors, run);
+        }
+        else
+          setPixelColor(fragment.indexV, color);
+        i += run;
+      }
+      else {
+        setPixelColor(fragment.indexV, blend(getPixelColor(fragment.indexV), color, fragment.coverage));
+        i++;
+      }
+    }
+    fragments.clear();
+  }
+
+  //WLEDMM shorten the line to depth / 255 of its length, false if nothing to paint
+  static bool shortenLine(int &x0, int &y0, int &z0, int &x1, int &y1, int &z1, uint8_t depth) {
+    if (depth == UINT8_MAX) return true;
+    if (depth == 0) return false; // nothing to paint
+    if (depth < 2) {x1 = x0; y1 = y0; z1 = z0; return true;} // single pixel
+    // we do everything "*2" for better rounding
+    x1 = (2 * x0 + ((2 * x1 - 2 * x0) * int(depth)) / 255 + 1) / 2;
+    y1 = (2 * y0 + ((2 * y1 - 2 * y0) * int(depth)) / 255 + 1) / 2;
+    z1 = (2 * z0 + ((2 * z1 - 2 * z0) * int(depth)) / 255 + 1) / 2;
+    return true;
+  }
+
+  void LedsLayer::rasterLine(int x0, int y0, int x1, int y1, bool soft, uint8_t depth) {
+    int z0 = 0, z1 = 0;
+    if (!shortenLine(x0, y0, z0, x1, y1, z1, depth)) return;
+
+    if (soft) { // Xiaolin Wu's algorithm, same as 3D
+      rasterLine3D(x0, y0, 0, x1, y1, 0, true);
+      return;
+    }
+
+    // Bresenham's algorithm
+    const int dx = abs(x1-x0), sx = x0<x1 ? 1 : -1;
+    const int dy = abs(y1-y0), sy = y0<y1 ? 1 : -1;
+    int err = (dx>dy ? dx : -dy)/2;   // error direction
+    for (;;) {
+      addFragment(x0, y0, 0, 255);
+      if (x0==x1 && y0==y1) break;
+      int e2 = err;
+      if (e2 >-dx) { err -= dy; x0 += sx; }
+      if (e2 < dy) { err += dx; y0 += sy; }
+    }
+  }
+
+  void LedsLayer::rasterLine3D(int x0, int y0, int z0, int x1, int y1, int z1, bool soft, uint8_t depth) {
+    if (!shortenLine(x0, y0, z0, x1, y1, z1, depth)) return;
+
+    int from[3] = {x0, y0, z0};
+    int to[3] = {x1, y1, z1};
+    int delta[3] = {abs(x1 - x0), abs(y1 - y0), abs(z1 - z0)};
+    //driving axis is the longest, the minor axes a and b
+    const int major = (delta[0] >= delta[1] && delta[0] >= delta[2])?0:(delta[1] >= delta[2])?1:2;
+    const int a = major == 0?1:0, b = major == 2?1:2;
+    const int steps = delta[major];
+    const int step = to[major] > from[major]?1:-1;
+
+    if (steps == 0) { // single pixel
+      addFragment(x0, y0, z0, 255);
+      return;
+    }
+
+    if (soft) {
+      // Xiaolin Wu's algorithm in 3D: minor axes in 16.16 fixed point, coverage spread over the 2 x 2 nearest pixels of the minor axes
+      const int32_t gradientA = (to[a] - from[a]) * 65536 / steps;
+      const int32_t gradientB = (to[b] - from[b]) * 65536 / steps;
+      int32_t posA = from[a] * 65536, posB = from[b] * 65536;
+      int pixel[3];
+      for (int i = 0; i <= steps; i++, posA += gradientA, posB += gradientB) {
+        pixel[major] = from[major] + i * step;
+        const uint8_t fracA = (posA >> 8) & 0xFF, fracB = (posB >> 8) & 0xFF;
+        for (int da = 0; da < 2; da++) for (int db = 0; db < 2; db++) {
+          pixel[a] = (posA >> 16) + da;
+          pixel[b] = (posB >> 16) + db;
+          const uint8_t coverageA = da?fracA:255 - fracA;
+          const uint8_t coverageB = db?fracB:255 - fracB;
+          addFragment(pixel[0], pixel[1], pixel[2], scale8(coverageA, coverageB));
+        }
+      }
+      return;
+    }
+
+    //Bresenham
+    int pixel[3] = {x0, y0, z0};
+    int signs[3] = {x1 > x0?1:-1, y1 > y0?1:-1, z1 > z0?1:-1};
+    int p1 = 2 * delta[a] - steps;
+    int p2 = 2 * delta[b] - steps;
+    addFragment(pixel[0], pixel[1], pixel[2], 255);
+    while (pixel[major] != to[major]) {
+      pixel[major] += step;
+      if (p1 >= 0) {
+        pixel[a] += signs[a];
+        p1 -= 2 * steps;
+      }
+      if (p2 >= 0) {
+        pixel[b] += signs[b];
+        p2 -= 2 * steps;
+      }
+      p1 += 2 * delta[a];
+      p2 += 2 * delta[b];
+      addFragment(pixel[0], pixel[1], pixel[2], 255);
+    }
+  }
+
+  void LedsLayer::rasterCircle(int cx, int cy, uint8_t radius, bool soft) {
+    if (radius == 0) return;
+    if (soft) {
+      // Xiaolin Wu's algorithm: per column the pixel inside and outside the circle, coverage by the fraction of the exact y
+      const int rsq = radius*radius;
+      for (int x = 0; ; x++) {
+        float yf = sqrtf(float(rsq - x*x));
+        if (x > yf) break;
+        const int y = yf;
+        const uint8_t outer = (yf - y) * 255; //coverage of the pixel outside
+        const uint8_t inner = 255 - outer;
+        const int offsets[2] = {y, y + 1};
+        const uint8_t coverages[2] = {inner, outer};
+        for (int i = 0; i < 2; i++) {
+          const int o = offsets[i];
+          const uint8_t c = coverages[i];
+          addFragment(cx+x, cy+o, 0, c); addFragment(cx-x, cy+o, 0, c);
+          addFragment(cx+x, cy-o, 0, c); addFragment(cx-x, cy-o, 0, c);
+          addFragment(cx+o, cy+x, 0, c); addFragment(cx-o, cy+x, 0, c);
+          addFragment(cx+o, cy-x, 0, c); addFragment(cx-o, cy-x, 0, c);
+        }
+      }
+    } else {
+      // Bresenham's Algorithm
+      int d = 3 - (2*radius);
+      int y = radius, x = 0;
+      while (y >= x) {
+        addFragment(cx+x, cy+y, 0, 255); addFragment(cx-x, cy+y, 0, 255);
+        addFragment(cx+x, cy-y, 0, 255); addFragment(cx-x, cy-y, 0, 255);
+        addFragment(cx+y, cy+x, 0, 255); addFragment(cx-y, cy+x, 0, 255);
+        addFragment(cx+y, cy-x, 0, 255); addFragment(cx-y, cy-x, 0, 255);
+        x++;
+        if (d > 0) {
+          y--;
+          d += 4 * (x - y) + 10;
+        } else {
+          d += 4 * x + 6;
+        }
+      }
+    }
+  }
+
+  void LedsLayer::rasterPolygon(const Coord3D *points, uint8_t count, bool filled, bool soft) {
+    if (count == 0) return;
+    if (filled) {
+      //even-odd scanline fill at pixel centers, spans of full coverage
+      int minY = points[0].y, maxY = points[0].y;
+      for (int i = 1; i < count; i++) {minY = min(minY, points[i].y); maxY = max(maxY, points[i].y);}
+      int crossings[16];
+      for (int y = max(minY, 0); y <= min(maxY, size.y - 1); y++) {
+        int nrOfCrossings = 0;
+        for (int i = 0; i < count && nrOfCrossings < 16; i++) {
+          const Coord3D &p0 = points[i], &p1 = points[(i + 1) % count];
+          if ((p0.y <= y) != (p1.y <= y)) //edge crosses the scanline
+            crossings[nrOfCrossings++] = p0.x + (y - p0.y) * (p1.x - p0.x) / (p1.y - p0.y);
+        }
+        std::sort(crossings, crossings + nrOfCrossings);
+        for (int i = 0; i + 1 < nrOfCrossings; i += 2)
+          for (int x = max(crossings[i], 0); x <= min(crossings[i + 1], size.x - 1); x++) addFragment(x, y, 0, 255);
+      }
+    }
+    for (int i = 0; i < count; i++)
+      rasterLine(points[i].x, points[i].y, points[(i + 1) % count].x, points[(i + 1) % count].y, soft);
+  }
+
+  void LedsLayer::rasterPoint(float x, float y, float z) {
+    const int ix = floorf(x), iy = floorf(y), iz = floorf(z);
+    const uint8_t fracX = (x - ix) * 255, fracY = (y - iy) * 255, fracZ = (z - iz) * 255;
+    for (int dz = 0; dz < (fracZ?2:1); dz++) for (int dy = 0; dy < 2; dy++) for (int dx = 0; dx < 2; dx++) {
+      const uint8_t coverage = scale8(scale8(dx?fracX:255 - fracX, dy?fracY:255 - fracY), dz?fracZ:255 - fracZ);
+      addFragment(ix + dx, iy + dy, iz + dz, coverage);
+    }
+  }
+
+  template <typename PhysMapT>
+  void LedsLayer::resetMappingTable(std::vector<PhysMapT> &table) {
+    for (size_t i = 0; i < table.size(); i++) {
+      table[i] = PhysMapT();
+    }
+  }
+
+  template <typename PhysMapT>
+  void LedsLayer::addMapping(std::vector<PhysMapT> &table, uint16_t indexV, uint16_t indexP) {
+    //create new physMaps if needed
+    if (indexV >= table.size()) {
+      for (size_t i = table.size(); i <= indexV; i++) {
+        // ppf("mapping add physMap before %d %d\n", indexV, table.size());
+        table.push_back(PhysMapT());
+      }
+    }
+
+    if (indexV >= mappingTableSizeUsed) mappingTableSizeUsed = indexV + 1;
+
+    table[indexV].addIndexP(*this, indexP);
+  }
+
+  template <typename PhysMapT>
+  void LedsLayer::completeMappingTable(std::vector<PhysMapT> &table, uint16_t &nrOfPhysical, uint16_t &nrOfPhysicalM, uint16_t &nrOfColor) {
+    if (table.size() < size.x * size.y * size.z)
+      ppf("addPixelsPost add extra physMap %d to %d size: %d,%d,%d\n", mappingTableSizeUsed, size.x * size.y * size.z, size.x, size.y, size.z);
+    for (size_t i = table.size(); i < size.x * size.y * size.z; i++) {
+      table.push_back(PhysMapT());
+      mappingTableSizeUsed++;
+    }
+
+    //debug info + summary values
+    for (size_t i = 0; i< mappingTableSizeUsed; i++) {
+      PhysMapT &map = table[i];
+      switch (map.mapType) {
+        case m_color:
+          nrOfColor++;
+          break;
+        case m_onePixel:
+          nrOfPhysical++;
+          break;
+        case m_morePixels:
+          nrOfPhysicalM += mappingTableIndexes[map.indexes].size();
+          break;
+      }
+    }
+  }
+
+  template <typename PhysMapT>
+  void LedsLayer::assignVirtualPixels(std::vector<PhysMapT> &table) {
+    uint16_t indexV = 0;
+    for (size_t i = 0; i < mappingTableSizeUsed; i++) {
+      if (table[i].mapType == m_color) table[i].rgb = indexV++; //rgb is now the index in ledsV
+    }
+  }
+
+  void LedsLayer::allocVirtualPixels(uint16_t nrOfColor) {
+    releaseVirtualPixels();
+    if (nrOfColor == 0 || virtualMode == vm_compact) return;
+    if (nrOfColor > PhysMap::maxIndex + 1 && !wideMapping) return; //index does not fit in the PhysMap
+
+    size_t bytes = nrOfColor * sizeof(CRGB);
+    //auto: always with PSRAM, otherwise only if it is a small part of the largest free block
+    if (virtualMode == vm_auto && !psramFound() && bytes > ESP.getMaxAllocHeap() / 4) {
+      ppf("allocVirtualPixels %d B not allocated (auto)\n", bytes);
+      return;
+    }
+
+    ledsV = (CRGB *)(psramFound()?ps_calloc(nrOfColor, sizeof(CRGB)):calloc(nrOfColor, sizeof(CRGB)));
+    if (!ledsV) {
+      ppf("allocVirtualPixels calloc failed %d B\n", bytes);
+      return;
+    }
+    nrOfLedsV = nrOfColor;
+    if (wideMapping)
+      assignVirtualPixels(mappingTableWide);
+    else
+      assignVirtualPixels(mappingTable);
+  }
+
+  void LedsLayer::releaseVirtualPixels() {
+    if (!ledsV) return;
+    free(ledsV);
+    ledsV = nullptr;
+    nrOfLedsV = 0;
+    //back to compact colors
+    if (wideMapping) {
+      for (size_t i = 0; i < mappingTableSizeUsed; i++) if (mappingTableWide[i].mapType == m_color) mappingTableWide[i].rgb = 0;
+    } else {
+      for (size_t i = 0; i < mappingTableSizeUsed; i++) if (mappingTable[i].mapType == m_color) mappingTable[i].rgb = 0;
+    }
+  }
+
+  template <typename PhysMapT>
+  uint16_t LedsLayer::nrOfCompactColors(const std::vector<PhysMapT> &table) const {
+    uint16_t nrOfColor = 0;
+    for (uint16_t indexV = 0; indexV < mappingTableSizeUsed; indexV++)
+      if (table[indexV].mapType == m_color) nrOfColor++;
+    return nrOfColor;
+  }
+
+  template <typename PhysMapT>
+  void LedsLayer::swapCompactColors(std::vector<PhysMapT> &table) {
+    std::vector<uint32_t> &compactColors = transition.compactColors;
+    size_t i = 0;
+    for (uint16_t indexV = 0; indexV < mappingTableSizeUsed && i < compactColors.size(); indexV++) {
+      if (table[indexV].mapType == m_color) {
+        uint32_t rgb = table[indexV].rgb;
+        table[indexV].rgb = compactColors[i];
+        compactColors[i++] = rgb;
+      }
+    }
+  }
+
+  size_t LedsLayer::transitionPixelBytes() const {
+    if (ledsV) return nrOfLedsV * sizeof(CRGB);
+    if (!projection) return 0;
+    return (wideMapping?nrOfCompactColors(mappingTableWide):nrOfCompactColors(mappingTable)) * sizeof(uint32_t);
+  }
+
+  bool LedsLayer::allocTransitionPixels() {
+    if (ledsV) {
+      transition.ledsV = (CRGB *)calloc(nrOfLedsV, sizeof(CRGB));
+      if (!transition.ledsV) {
+        ppf("allocTransitionPixels calloc failed %d B\n", nrOfLedsV * sizeof(CRGB));
+        return false;
+      }
+      transition.nrOfLedsV = nrOfLedsV;
+    }
+    else if (projection)
+      transition.compactColors.assign(wideMapping?nrOfCompactColors(mappingTableWide):nrOfCompactColors(mappingTable), 0);
+    swapTransitionPixels(); //black for the incoming effect
+    return true;
+  }
+
+  void LedsLayer::swapTransitionPixels() {
+    if (transition.ledsV)
+      std::swap(ledsV, transition.ledsV);
+    else if (transition.compactColors.size()) {
+      if (wideMapping)
+        swapCompactColors(mappingTableWide);
+      else
+        swapCompactColors(mappingTable);
+    }
+  }
+
+  template <typename PhysMapT>
+  bool LedsLayer::isContiguous(const std::vector<PhysMapT> &table) const {
+    if (mappingTableSizeUsed == 0) return false;
+    uint16_t firstIndexP = table[0].indexP;
+    for (uint16_t indexV = 0; indexV < mappingTableSizeUsed; indexV++)
+      if (table[indexV].indexP != firstIndexP + indexV) return false;
+    return true;
+  }
+
+  void LedsLayer::classifyMapping(uint16_t nrOfColor, uint16_t nrOfPhysicalM) {
+    if (!projection) {
+      mapShape = ms_contiguous;
+      contiguousStart = 0;
+      contiguousSize = fix->nrOfLeds;
+    }
+    else if (nrOfColor > 0)
+      mapShape = ms_mixed;
+    else if (nrOfPhysicalM > 0)
+      mapShape = ms_fanOut;
+    else if (wideMapping?isContiguous(mappingTableWide):isContiguous(mappingTable)) {
+      mapShape = ms_contiguous;
+      contiguousStart = wideMapping?mappingTableWide[0].indexP:mappingTable[0].indexP;
+      contiguousSize = mappingTableSizeUsed;
+    }
+    else
+      mapShape = ms_oneToOne;
+
+    switch (mapShape) {
+      case ms_contiguous:
+        writePixelColorCached = &LedsLayer::writePixelContiguous;
+        readPixelColorCached = &LedsLayer::readPixelContiguous;
+        break;
+      case ms_oneToOne:
+        writePixelColorCached = wideMapping?&LedsLayer::writePixelOneToOneWide:&LedsLayer::writePixelOneToOne;
+        readPixelColorCached = wideMapping?&LedsLayer::readPixelOneToOneWide:&LedsLayer::readPixelOneToOne;
+        break;
+      default:
+        writePixelColorCached = &LedsLayer::writePixelColor;
+        readPixelColorCached = &LedsLayer::readPixelColor;
+    }
+    if (ledsPal) { //palette mode: all pixels in ledsPal, mapShape only used by resolvePalettePixels
+      writePixelColorCached = &LedsLayer::writePixelPal;
+      readPixelColorCached = &LedsLayer::readPixelPal;
+    }
+    ppf("classifyMapping %s %d-%d\n", mapShape == ms_contiguous?"contiguous":mapShape == ms_oneToOne?"one to one":mapShape == ms_fanOut?"fan out":"mixed", contiguousStart, contiguousSize);
+  }
+
+  void LedsLayer::allocPalettePixels(uint16_t nrOfVirtual) {
+    releasePalettePixels();
+    if (!paletteMode || nrOfVirtual == 0) return;
+
+    ledsPal = (PalPixel *)(psramFound()?ps_calloc(nrOfVirtual, sizeof(PalPixel)):calloc(nrOfVirtual, sizeof(PalPixel)));
+    paletteLUT = (CRGB *)malloc(256 * sizeof(CRGB));
+    if (!ledsPal || !paletteLUT) {
+      ppf("allocPalettePixels failed %d B\n", nrOfVirtual * sizeof(PalPixel) + 256 * sizeof(CRGB));
+      releasePalettePixels();
+      return;
+    }
+    nrOfLedsPal = nrOfVirtual;
+    for (int i = 0; i < 256; i++) paletteLUT[i] = ColorFromPalette(palette, i);
+    paletteLUTSource = palette;
+  }
+
+  void LedsLayer::releasePalettePixels() {
+    if (writePixelColorCached == &LedsLayer::writePixelPal) { //generic set and get, ledsP has the last resolved colors
+      writePixelColorCached = &LedsLayer::writePixelColor;
+      readPixelColorCached = &LedsLayer::readPixelColor;
+    }
+    free(ledsPal);
+    ledsPal = nullptr;
+    nrOfLedsPal = 0;
+    free(paletteLUT);
+    paletteLUT = nullptr;
+  }
+
+  template <typename PhysMapT>
+  void LedsLayer::resolveMapped(const PhysMapT &physMap, const CRGB &color) {
+    switch (physMap.mapType) {
+      case m_onePixel:
+        compositePixel(fix->ledsP[physMap.indexP], color, blendMode, opacity);
+        break;
+      case m_morePixels:
+        for (uint16_t indexP: mappingTableIndexes[physMap.indexes]) compositePixel(fix->ledsP[indexP], color, blendMode, opacity);
+        break;
+      default: ; //unmapped pixels only live in ledsPal
+    }
+  }
+
+  void LedsLayer::resolvePalettePixels() {
+    if (!ledsPal) return;
+
+    //256 colors only recalculated if the palette changed, then per pixel a lookup and a scale
+    if (paletteLUTSource != palette) {
+      for (int i = 0; i < 256; i++) paletteLUT[i] = ColorFromPalette(palette, i);
+      paletteLUTSource = palette;
+    }
+
+    if (mapShape == ms_contiguous && blendMode == bm_alpha && opacity == 255) { //straight into ledsP
+      CRGB *ledsP = fix->ledsP + contiguousStart;
+      for (uint16_t indexV = 0; indexV < nrOfLedsPal; indexV++) {
+        ledsP[indexV] = paletteLUT[ledsPal[indexV].index];
+        ledsP[indexV].nscale8(ledsPal[indexV].bri);
+      }
+      return;
+    }
+
+    for (uint16_t indexV = 0; indexV < nrOfLedsPal; indexV++) {
+      CRGB color = paletteLUT[ledsPal[indexV].index];
+      color.nscale8(ledsPal[indexV].bri);
+      if (!projection)
+        compositePixel(fix->ledsP[indexV], color, blendMode, opacity);
+      else if (wideMapping)
+        resolveMapped(mappingTableWide[indexV], color);
+      else
+        resolveMapped(mappingTable[indexV], color);
+    }
+  }
+
+  size_t LedsLayer::bytesAllocated() const {
+    size_t bytes = mappingTable.capacity() * sizeof(PhysMap) + mappingTableWide.capacity() * sizeof(PhysMapWide);
+    for (const std::vector<uint16_t> &mappingTableIndex: mappingTableIndexes)
+      bytes += mappingTableIndex.capacity() * sizeof(uint16_t);
+    bytes += nrOfLedsV * sizeof(CRGB);
+    if (ledsPal) bytes += nrOfLedsPal * sizeof(PalPixel) + 256 * sizeof(CRGB);
+    if (ledsL) bytes += indexesP.size() * (sizeof(CRGB) + sizeof(uint16_t));
+    bytes += transition.bytesAllocated();
+    bytes += proPixels.pixels.capacity() * sizeof(ProjectedPixels::Pixel);
+    for (const RadialField &field: radialFields)
+      bytes += field.polar.capacity() * sizeof(RadialField::Polar);
+    for (const TextBitmap &textBitmap: textBitmaps)
+      bytes += textBitmap.bits.capacity();
+    bytes += effectData.bytesAllocated + effectCache.bytesAllocated + projectionData.bytesAllocated;
+    return bytes;
+  }
+
   void LedsLayer::addPixelsPre(const uint8_t rowNr) {
     if (doMap) {
+      transition.end(); //physical pixels will change
+      proPixels.invalidate(0); //rebuilt by the projection loop if enabled
+      //fields not used since the previous remap are freed, others are kept for the effect and projection to find back
+      for (RadialField &field: radialFields) {
+        if (!field.users) field.release();
+        field.users = 0;
+      }
+      releaseLayerPixels();
+      releaseVirtualPixels();
+      releasePalettePixels();
       fill_solid(CRGB::Black);
+      //generic set and get while mapping
+      mapShape = ms_mixed;
+      writePixelColorCached = &LedsLayer::writePixelColor;
+      readPixelColorCached = &LedsLayer::readPixelColor;
 
       ppf("addPixelsPre clear leds[x] effect:%s pro:%s\n", effect?effect->name():"None", projection?projection->name():"None");
       size = Coord3D{0,0,0};
@@ -327,8 +1232,14 @@ void LedsLayer::fill_rainbow(const uint8_t initialhue, const uint8_t deltahue) {
       }
       mappingTableIndexesSizeUsed = 0; //do not clear mappingTableIndexes, reuse it
 
-      for (size_t i = 0; i < mappingTable.size(); i++) {
-        mappingTable[i] = PhysMap();
+      //compact entries unless the fixture has more leds then they can index
+      wideMapping = fix->nrOfLeds > PhysMap::maxIndex + 1;
+      if (wideMapping) {
+        resetMappingTable(mappingTableWide);
+        mappingTable.clear(); mappingTable.shrink_to_fit();
+      } else {
+        resetMappingTable(mappingTable);
+        mappingTableWide.clear(); mappingTableWide.shrink_to_fit();
       }
       mappingTableSizeUsed = 0;
 
@@ -375,21 +1286,13 @@ void LedsLayer::fill_rainbow(const uint8_t initialhue, const uint8_t deltahue) {
         if (pixel.x != UINT16_MAX) { //can be set to UINT16_MAX by projection
           uint16_t indexV = XYZUnprojected(pixel);
 
-          if (indexV >= size.x * size.y * size.z || indexV >= STARLIGHT_MAXLEDS)
-            ppf("dev addPixel leds[%d] indexV too high %d>=%d or %d (m:%d p:%d) p:%d,%d,%d s:%d,%d,%d\n", rowNr, indexV, size.x * size.y * size.z, STARLIGHT_MAXLEDS, mappingTableSizeUsed, fix->indexP, pixel.x, pixel.y, pixel.z, size.x, size.y, size.z);
+          if (indexV >= size.x * size.y * size.z)
+            ppf("dev addPixel leds[%d] indexV too high %d>=%d (m:%d p:%d) p:%d,%d,%d s:%d,%d,%d\n", rowNr, indexV, size.x * size.y * size.z, mappingTableSizeUsed, fix->indexP, pixel.x, pixel.y, pixel.z, size.x, size.y, size.z);
           else {
-            //create new physMaps if needed
-            if (indexV >= mappingTable.size()) {
-              for (size_t i = mappingTable.size(); i <= indexV; i++) {
-                // ppf("mapping %d,%d,%d add physMap before %d %d\n", pixel.y, pixel.y, pixel.z, indexV, mappingTable.size());
-                mappingTable.push_back(PhysMap());
-                // mappingTableIndexesSizeUsed++;
-              }
-            }
-
-            if (indexV >= mappingTableSizeUsed) mappingTableSizeUsed = indexV + 1;
-
-            mappingTable[indexV].addIndexP(*this, fix->indexP);
+            if (wideMapping)
+              addMapping(mappingTableWide, indexV, fix->indexP);
+            else
+              addMapping(mappingTable, indexV, fix->indexP);
             // ppf("mapping b:%d t:%d V:%d\n", indexV, indexP, mappingTableSizeUsed);
           } //indexV not too high
         } //pixel.x != UINT16_MAX
@@ -413,51 +1316,32 @@ void LedsLayer::fill_rainbow(const uint8_t initialhue, const uint8_t deltahue) {
         size = fix->fixSize;
         nrOfPhysical = fix->nrOfLeds;
 
+        allocPalettePixels(fix->nrOfLeds);
+
       } else {
 
-        if (mappingTable.size() < size.x * size.y * size.z)
-          ppf("addPixelsPost add extra physMap %d to %d size: %d,%d,%d\n", mappingTableSizeUsed, size.x * size.y * size.z, size.x, size.y, size.z);
-        for (size_t i = mappingTable.size(); i < size.x * size.y * size.z; i++) {
-          mappingTable.push_back(PhysMap());
-          mappingTableSizeUsed++;
-        }
+        if (wideMapping)
+          completeMappingTable(mappingTableWide, nrOfPhysical, nrOfPhysicalM, nrOfColor);
+        else
+          completeMappingTable(mappingTable, nrOfPhysical, nrOfPhysicalM, nrOfColor);
+        nrOfLogical = mappingTableSizeUsed;
 
-        //debug info + summary values
-        for (size_t i = 0; i< mappingTableSizeUsed; i++) {
-          PhysMap &map = mappingTable[i];
-          switch (map.mapType) {
-            case m_color:
-              nrOfColor++;
-              break;
-            case m_onePixel:
-              // ppf("ledV %d mapping =1: #ledsP : %d\n", nrOfLogical, map.indexP);
-              nrOfPhysical++;
-              break;
-            case m_morePixels:
-              // ppf("ledV %d mapping >1: #ledsP :", nrOfLogical);
-              
-              for (uint16_t indexP: mappingTableIndexes[map.indexes]) {
-                // ppf(" %d", indexP);
-                nrOfPhysicalM++;
-              }
-              // ppf("\n");
-              break;
-          }
-          nrOfLogical++;
-          // else
-          //   ppf("ledV %d no mapping\n", x);
-        }
+        allocPalettePixels(mappingTableSizeUsed);
+        if (!ledsPal) allocVirtualPixels(nrOfColor); //palette mode: unmapped pixels are in ledsPal
       }
 
+      classifyMapping(nrOfColor, nrOfPhysicalM);
+
       ppf("addPixelsPost leds[%d] V:%d x %d x %d (v:%d - p:%d pm:%d of %d c:%d)\n", rowNr, size.x, size.y, size.z, nrOfLogical, nrOfPhysical, nrOfPhysicalM, mappingTableIndexesSizeUsed, nrOfColor);
 
       StarString buf;
       buf.format("%d x %d x %d", size.x, size.y, size.z);
       mdl->setValue("layers", "size", JsonString(buf.getString()), rowNr);
 
-      ppf("addPixelsPost leds[%d].size = so:%d + m:(%d of %d) * %d + d:(%d + %d) B\n", rowNr, sizeof(LedsLayer), mappingTableSizeUsed, mappingTable.size(), sizeof(PhysMap), effectData.bytesAllocated, projectionData.bytesAllocated); //44 -> 164
+      ppf("addPixelsPost leds[%d].size = so:%d + m:(%d of %d) * %d + d:(%d + %d) B\n", rowNr, sizeof(LedsLayer), mappingTableSizeUsed, wideMapping?mappingTableWide.size():mappingTable.size(), wideMapping?sizeof(PhysMapWide):sizeof(PhysMap), effectData.bytesAllocated, projectionData.bytesAllocated); //44 -> 164
 
       doMap = false;
+      doResize = true; //effect recalculates its per size constants
     } //doMap
 
   }
\ No newline at end of file
@@ -19,14 +19,11 @@
 // #define I2S_DEVICE 1                  // I2S driver: allows to still use I2S#0 for audio (only on esp32 and esp32-s3)
 // #define FASTLED_I2S_MAX_CONTROLLERS 8 // 8 LED pins should be enough (default = 24)
 
+#include <new> //placement new
 #include "FastLED.h" //CRGB
 
 #include "../Sys/SysModModel.h" //for Coord3D
 
-#ifndef STARLIGHT_MAXLEDS
-  #define STARLIGHT_MAXLEDS 8192 //any board can do this
-#endif
-
 class LedsLayer; //forward
 
 #define _1D 1
@@ -44,6 +41,9 @@ public:
 
   virtual void setup(LedsLayer &leds, Variable parentVar);
 
+  //after initEffect and after each remap, before loop: per size constants (divisions, tables) in leds.effectCache
+  virtual void resize(LedsLayer &leds) {}
+
   virtual void loop(LedsLayer &leds) {}
 };
 
@@ -56,7 +56,10 @@ public:
 
   virtual void setup(LedsLayer &leds, Variable parentVar) {}
 
-  //per frame
+  //per frame, before the effect loop (e.g. what XYZ needs for this frame)
+  virtual void loopPre(LedsLayer &leds) {}
+
+  //per frame, after the effect loop
   virtual void loop(LedsLayer &leds) {}
   
   //setupPixels
@@ -67,6 +70,8 @@ public:
 
   //loopPixel
   virtual void XYZ(LedsLayer &leds, Coord3D &pixel) {}
+  //true if XYZ changes pixels (then spans are written pixel by pixel)
+  virtual bool hasXYZ() {return false;}
 };
 
 enum mapType {
@@ -76,24 +81,74 @@ enum mapType {
   m_count //keep as last entry
 };
 
-struct PhysMap {
+//how a layer is composited on the layers below it
+enum blendModes {
+  bm_alpha,
+  bm_add,
+  bm_multiply,
+  bm_screen,
+  bm_max,
+  bm_count //keep as last entry
+};
+
+//shape of the mapping of a layer, set after mapping to pick the fastest setPixelColor / getPixelColor
+enum mapShapes {
+  ms_contiguous, //indexP = start + indexV (also no projection)
+  ms_oneToOne, //every virtual pixel has one physical pixel, permuted
+  ms_fanOut, //every virtual pixel has one or more physical pixels
+  ms_mixed, //also unmapped virtual pixels
+  ms_count //keep as last entry
+};
+
+//how unmapped virtual pixels (m_color) are stored
+enum virtualModes {
+  vm_auto, //full if memory allows
+  vm_compact, //in the PhysMap itself (554 RGB, 888 if wide)
+  vm_full, //in ledsV, the PhysMap holds the index in ledsV
+  vm_count //keep as last entry
+};
+
+//T = uint16_t: compact, 14 bits index, T = uint32_t: wide, 30 bits index
+template <typename T>
+struct PhysMapT {
+  static const uint8_t indexBits = sizeof(T) * 8 - 2;
+  static const uint32_t maxIndex = (1UL << indexBits) - 1; //16383 or 1073741823
+
   union {
     struct {                 //condensed rgb
-      uint16_t rgb14: 14;    //14 bits (554 RGB)
-      byte mapType:2;        //2 bits (4)
-    }; //16 bits
-    uint16_t indexP: 14;   //16384 one physical pixel (type==1) index to ledsP array
-    uint16_t indexes:14;  //16384 multiple physical pixels (type==2) index in std::vector<std::vector<uint16_t>> mappingTableIndexes;
-  }; // 2 bytes
-
-  PhysMap() {
+      T rgb: indexBits;      //554 RGB (14 bits) or 888 RGB (30 bits)
+      T mapType:2;           //2 bits (4)
+    };
+    T indexP: indexBits;   //one physical pixel (type==1) index to ledsP array
+    T indexes: indexBits;  //multiple physical pixels (type==2) index in std::vector<std::vector<uint16_t>> mappingTableIndexes;
+  }; // sizeof(T) bytes
+
+  PhysMapT() {
     mapType = m_color; // the default until indexP is added
-    rgb14 = 0;
+    rgb = 0;
   }
 
   void addIndexP(LedsLayer &leds, uint16_t indexP);
 
-}; // 2 bytes
+  void setRGB(const CRGB &color) {
+    if (sizeof(T) == 2)
+      rgb = ((min(color.r + 3, 255) >> 3) << 9) + 
+            ((min(color.g + 3, 255) >> 3) << 4) + 
+             (min(color.b + 7, 255) >> 4);
+    else
+      rgb = ((uint32_t)color.r << 16) + (color.g << 8) + color.b;
+  }
+
+  CRGB getRGB() const {
+    if (sizeof(T) == 2)
+      return CRGB((rgb >> 9) << 3, (rgb >> 4) << 3, rgb << 4);
+    else
+      return CRGB(rgb >> 16, rgb >> 8, rgb);
+  }
+};
+
+typedef PhysMapT<uint16_t> PhysMap; // 2 bytes, fixtures up to 16384 leds
+typedef PhysMapT<uint32_t> PhysMapWide; // 4 bytes, bigger fixtures
 
 //StarLight implementation of segment.data
 class SharedData {
@@ -105,7 +160,10 @@ class SharedData {
 
   public:
     uint16_t bytesAllocated = 0;
+    uint16_t bytesUsed = 0; //highest index since clear: the footprint
     bool alertIfChanged = false;
+    bool sizing = false; //sizing pass (first loop): grow fast, fit() then allocates the footprint once
+    static constexpr uint16_t psramFrom = 1024; //data of this size or bigger goes to PSRAM if available
 
   SharedData() {
     ppf("SharedData constructor %d %d\n", index, bytesAllocated);
@@ -122,11 +180,26 @@ class SharedData {
       data = nullptr;
     }
     bytesAllocated = 0;
+    bytesUsed = 0;
     alertIfChanged = false;
+    sizing = false;
     dataAllocated = true;
     begin();
   }
 
+  //end of the sizing pass: move the data to one allocation of exactly the footprint, existing bytes are kept
+  void fit() {
+    sizing = false;
+    if (data == nullptr || bytesUsed == bytesAllocated) return;
+    byte *newData = (byte*) ((psramFound() && bytesUsed >= psramFrom)?ps_malloc(bytesUsed):malloc(bytesUsed));
+    if (newData == nullptr) return; //keep the current allocation
+    memcpy(newData, data, bytesUsed);
+    free(data);
+    data = newData;
+    ppf("sharedData.fit %d->%d\n", bytesAllocated, bytesUsed);
+    bytesAllocated = bytesUsed;
+  }
+
   //sets the effectData pointer back to 0 so loop effect can go through it
   void begin() {
     index = 0;
@@ -137,15 +210,21 @@ class SharedData {
   Type * readWrite(int length = 1) {
     if (!dataAllocated) return nullptr;
     size_t newIndex = index + length * sizeof(Type);
+    if (newIndex > bytesUsed) bytesUsed = newIndex;
     if (newIndex > bytesAllocated) {
-      size_t newSize = bytesAllocated + (1 + ( newIndex - bytesAllocated)/32) * 32; // add a multitude of 32 bytes
+      size_t newSize;
+      if (sizing) //double, fit() shrinks to the footprint
+        newSize = max(newIndex, (size_t)bytesAllocated * 2);
+      else
+        newSize = bytesAllocated + (1 + ( newIndex - bytesAllocated)/32) * 32; // add a multitude of 32 bytes
+      if (newSize > UINT16_MAX) newSize = max(newIndex, (size_t)UINT16_MAX);
       ppf("sharedData.readWrite add more %d->%d %d->%d\n", index, newIndex, bytesAllocated, newSize);
       if (bytesAllocated == 0)
         data = (byte*) malloc(newSize);
       else
         data = (byte*)reallocf(data, newSize);
       if (data != nullptr) { //only if alloc is successful
-        memset(data, 0, newSize); //init data with 0
+        memset(data + bytesAllocated, 0, newSize - bytesAllocated); //init added data with 0, keep existing (e.g. state)
         if (alertIfChanged)
           ppf("dev sharedData.readWrite reallocating, this should not happen ! %d -> %d\n", bytesAllocated, newSize);
         bytesAllocated = newSize;
@@ -161,6 +240,31 @@ class SharedData {
     return returnValue;
   }
 
+  //typed state: all fixed size data of an effect in one struct at the start of data, allocated once
+  //  default member initializers are the defaults of the controls, setup binds controls to its members, loop gets the same typed pointer
+  //  variable length arrays can follow using readWrite
+  template <typename State>
+  State * state() {
+    if (!dataAllocated) return nullptr;
+    if (bytesAllocated < sizeof(State)) {
+      if (bytesAllocated != 0) {
+        ppf("dev sharedData.state already in use by sequential data %d < %d\n", bytesAllocated, sizeof(State));
+        return nullptr;
+      }
+      data = (byte*) malloc(sizeof(State));
+      if (data == nullptr) {
+        ppf("dev sharedData.state, alloc not successful %d\n", sizeof(State));
+        dataAllocated = false;
+        return nullptr;
+      }
+      new (data) State(); //default member initializers
+      bytesAllocated = sizeof(State);
+    }
+    if (bytesUsed < sizeof(State)) bytesUsed = sizeof(State);
+    index = sizeof(State); //readWrite continues after the state
+    return reinterpret_cast<State *>(data);
+  }
+
   //returns the next pointer initialized by a value (length for arrays not supported yet)
   template <typename Type>
   Type * write(Type initValue) {
@@ -180,6 +284,201 @@ class SharedData {
     return dataAllocated;
   }
 
+  //exchange the data with other (e.g. to keep the data of an outgoing effect)
+  void swap(SharedData &other) {
+    std::swap(data, other.data);
+    std::swap(index, other.index);
+    std::swap(dataAllocated, other.dataAllocated);
+    std::swap(bytesAllocated, other.bytesAllocated);
+    std::swap(bytesUsed, other.bytesUsed);
+    std::swap(sizing, other.sizing);
+    std::swap(alertIfChanged, other.alertIfChanged);
+  }
+
+  //raw bytes, used by snapshots
+  const byte *getData() const {
+    return data;
+  }
+
+  //overwrite all bytes, only if the layout is the same (same effect / projection)
+  bool setData(const byte *source, uint16_t length) {
+    if (data == nullptr || length != bytesAllocated) return false;
+    memcpy(data, source, length);
+    return true;
+  }
+
+  //overwrite length bytes at offset (e.g. a recorded control change)
+  bool setData(const byte *source, uint16_t offset, uint16_t length) {
+    if (data == nullptr || offset + length > bytesAllocated) return false;
+    memcpy(data + offset, source, length);
+    return true;
+  }
+
+};
+
+//outgoing effect of a layer, kept running during a transition to the new effect
+struct Transition {
+  Effect *effect = nullptr; //nullptr if no transition
+  SharedData effectData;
+  SharedData effectCache;
+  CRGBPalette16 palette;
+  std::vector<uint16_t> indexesP; //physical pixels of the layer
+  CRGB *buffer = nullptr; //outgoing frame followed by incoming frame, indexesP.size() each
+  //unmapped pixels of the other effect, swapped with the layer's like effectData
+  CRGB *ledsV = nullptr;
+  uint16_t nrOfLedsV = 0;
+  std::vector<uint32_t> compactColors; //if the layer has no ledsV: the rgb of its m_color mapping entries
+  unsigned long start = 0;
+
+  ~Transition() {free(buffer); free(ledsV);}
+
+  size_t bytesAllocated() const {
+    if (!buffer) return 0;
+    return indexesP.size() * (2 * sizeof(CRGB) + sizeof(uint16_t)) + nrOfLedsV * sizeof(CRGB) + compactColors.capacity() * sizeof(uint32_t);
+  }
+
+  void end() {
+    effect = nullptr;
+    effectData.clear();
+    effectCache.clear();
+    free(buffer);
+    buffer = nullptr;
+    indexesP.clear();
+    indexesP.shrink_to_fit();
+    free(ledsV);
+    ledsV = nullptr;
+    nrOfLedsV = 0;
+    compactColors.clear();
+    compactColors.shrink_to_fit();
+  }
+};
+
+//quarter sine wave in Q15 (32767 = 1.0), 64 steps of 90/64 degrees, generated with round(sin(i * PI / 128) * 32767)
+static const int16_t sinTableQ15[65] = {
+  0, 804, 1608, 2410, 3212, 4011, 4808, 5602, 6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+  12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530, 18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+  23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790, 27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+  30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+  32767
+};
+
+//angle: 65536 is a full circle, returns Q15, linear interpolation between table entries
+inline int16_t sinQ15(uint16_t angle) {
+  uint16_t pos = angle & 0x3FFF;
+  if (angle & 0x4000) pos = 0x4000 - pos; //2nd and 4th quarter are mirrored
+  uint8_t i = pos >> 8;
+  int16_t value = (i < 64)? sinTableQ15[i] + (((sinTableQ15[i+1] - sinTableQ15[i]) * (pos & 0xFF)) >> 8): sinTableQ15[64];
+  return (angle & 0x8000)? -value: value;
+}
+inline int16_t cosQ15(uint16_t angle) {return sinQ15(angle + 0x4000);}
+
+//factor * valueQ15, rounded
+inline int16_t mulQ15(int32_t factor, int16_t valueQ15) {return (factor * valueQ15 + (1 << 14)) >> 15;}
+
+//tilt, pan and roll combined in one 3x3 matrix (Q15), computed once per frame, applied per pixel with integer math
+struct RotationQ15 {
+  int32_t m[3][3] = {{1 << 15, 0, 0}, {0, 1 << 15, 0}, {0, 0, 1 << 15}};
+  uint16_t angles[3] = {0, 0, 0};
+
+  //binary angles (65536 is a full circle), applied in Trigo::rotate order: tilt, pan, roll. Returns false if unchanged
+  bool set(uint16_t tilt, uint16_t pan, uint16_t roll) {
+    if (tilt == angles[0] && pan == angles[1] && roll == angles[2]) return false;
+    angles[0] = tilt; angles[1] = pan; angles[2] = roll;
+    int32_t st = sinQ15(tilt), ct = cosQ15(tilt);
+    int32_t sp = sinQ15(pan), cp = cosQ15(pan);
+    int32_t sr = sinQ15(roll), cr = cosQ15(roll);
+    //pan * tilt
+    int32_t pt[3][3] = {{cp, (sp * st) >> 15, (sp * ct) >> 15},
+                        {0, ct, -st},
+                        {-sp, (cp * st) >> 15, (cp * ct) >> 15}};
+    //roll * pan * tilt
+    for (int col = 0; col < 3; col++) {
+      m[0][col] = (cr * pt[0][col] - sr * pt[1][col]) >> 15;
+      m[1][col] = (sr * pt[0][col] + cr * pt[1][col]) >> 15;
+      m[2][col] = pt[2][col];
+    }
+    return true;
+  }
+
+  //coordinates relative to middle should stay below 16K to not overflow
+  Coord3D apply(const Coord3D &in, const Coord3D &middle) const {
+    Coord3D inM = in - middle;
+    Coord3D out;
+    out.x = (m[0][0] * inM.x + m[0][1] * inM.y + m[0][2] * inM.z + (1 << 14)) >> 15;
+    out.y = (m[1][0] * inM.x + m[1][1] * inM.y + m[1][2] * inM.z + (1 << 14)) >> 15;
+    out.z = (m[2][0] * inM.x + m[2][1] * inM.y + m[2][2] * inM.z + (1 << 14)) >> 15;
+    return out + middle;
+  }
+};
+
+//1 bit per pixel mask, rows of (width + 7) / 8 bytes, msb is the left pixel
+struct Bitmap {
+  uint16_t width = 0, height = 0;
+  std::vector<uint8_t> bits;
+
+  uint16_t rowBytes() const {return (width + 7) / 8;}
+  void resize(uint16_t width, uint16_t height) {this->width = width; this->height = height; bits.assign(rowBytes() * height, 0);}
+  void release() {bits.clear(); bits.shrink_to_fit(); width = height = 0;}
+  bool get(int x, int y) const {return (bits[y * rowBytes() + (x >> 3)] >> (7 - (x & 7))) & 1;}
+};
+
+//text rasterized once with a console font, rebuilt only if text or font changes
+struct TextBitmap: Bitmap {
+  String text;
+  uint8_t font = UINT8_MAX;
+  unsigned long lastUsed = 0;
+
+  static Coord3D fontSize(uint8_t font);
+  static uint8_t fontRow(uint8_t font, unsigned char chr, uint8_t row); //bits of a row of a glyph, msb left
+  void rasterize(const char *text, uint8_t font);
+};
+
+//optional per pixel cache of XYZ results of a projection, valid as long as the projection does not change between frames
+struct ProjectedPixels {
+  struct Pixel {int16_t x, y, z;};
+  std::vector<Pixel> pixels; //empty if disabled
+  bool enabled = false;
+
+  //call when the projection changes (or the layer resizes), nrOfPixels: size.x * size.y * size.z
+  void invalidate(size_t nrOfPixels) {
+    if (enabled) pixels.assign(nrOfPixels, Pixel{INT16_MIN, 0, 0});
+    else if (!pixels.empty()) {pixels.clear(); pixels.shrink_to_fit();}
+  }
+  //index of an unprojected pixel or -1 if not cached
+  int index(const Coord3D &pixel, const Coord3D &size) const {
+    if (pixels.empty() || pixel.x < 0 || pixel.y < 0 || pixel.z < 0 || pixel.x >= size.x || pixel.y >= size.y || pixel.z >= size.z) return -1;
+    int i = pixel.x + pixel.y * size.x + pixel.z * size.x * size.y;
+    return i < (int)pixels.size()?i:-1;
+  }
+  bool get(int i, Coord3D &pixel) const {
+    if (i < 0 || pixels[i].x == INT16_MIN) return false;
+    pixel = Coord3D{pixels[i].x, pixels[i].y, pixels[i].z};
+    return true;
+  }
+  void set(int i, const Coord3D &pixel) {
+    if (i >= 0) pixels[i] = Pixel{(int16_t)pixel.x, (int16_t)pixel.y, (int16_t)pixel.z};
+  }
+};
+
+//distance and angle of each pixel to a center, built once per mapping (or center change) instead of sqrt and atan2 per pixel per frame
+struct RadialField {
+  struct Polar {
+    uint16_t distance; //in 1/16 pixel
+    uint16_t angle; //in the xy plane, 65536 is a full circle
+  };
+  std::vector<Polar> polar; //x, y, z order
+  Coord3D size = {0,0,0};
+  Coord3D center2 = {0,0,0}; //center * 2 so the center can be in between pixels
+
+  static constexpr uint8_t byEffect = 1, byProjection = 2;
+  uint8_t users = 0; //byEffect | byProjection, unreferenced fields stay cached until the next remap or reuse
+  unsigned long lastUsed = 0;
+
+  void build(const Coord3D &size, const Coord3D &center2);
+  void release() {polar.clear(); polar.shrink_to_fit(); size = {0,0,0}; users = 0;}
+
+  const Polar &at(const Coord3D &pixel) const {return polar[pixel.x + pixel.y * size.x + pixel.z * size.x * size.y];}
+  float distance(const Coord3D &pixel) const {return at(pixel).distance / 16.0f;}
 };
 
 class LedsLayer {
@@ -197,6 +496,7 @@ public:
   void (Projection::*addPixelsPreCached)(LedsLayer &) = &Projection::addPixelsPre;
   void (Projection::*addPixelCached)(LedsLayer &, Coord3D &) = &Projection::addPixel;
   void (Projection::*XYZCached)(LedsLayer &, Coord3D &) = &Projection::XYZ;
+  void (Projection::*loopPreCached)(LedsLayer &) = &Projection::loopPre;
   void (Projection::*loopCached)(LedsLayer &) = &Projection::loop;
 
   uint8_t effectDimension = UINT8_MAX;
@@ -210,11 +510,52 @@ public:
   uint8_t proTiltSpeed = 128;
   uint8_t proPanSpeed = 128;
   uint8_t proRollSpeed = 128;
+  RotationQ15 proRotation; //TiltPanRoll: rotation of the current frame
+  ProjectedPixels proPixels; //TiltPanRoll and Rotate
+  static constexpr uint8_t nrOfRadialFields = 3;
+  RadialField radialFields[nrOfRadialFields]; //polar maps shared by effects and projections of this layer
+  TextBitmap textBitmaps[2]; //glyph cache of drawText, 2 so e.g. scrolling text and the ticker do not evict each other
 
   SharedData effectData;
+  SharedData effectCache; //built by Effect::resize, cleared on each resize
+  bool doResize = false; //set when mapped, resizeEffect runs before the next loop
   SharedData projectionData;
 
   std::vector<PhysMap> mappingTable;
+  std::vector<PhysMapWide> mappingTableWide; //used instead of mappingTable if the fixture has more leds then PhysMap can index
+  bool wideMapping = false; //set at mapping time
+
+  uint8_t mapShape = ms_mixed; //set at mapping time
+  uint16_t contiguousStart = 0; //ms_contiguous
+  uint16_t contiguousSize = 0;
+  //cached set and get per mapShape (mixed and fanOut use the generic ones)
+  void (LedsLayer::*writePixelColorCached)(int, const CRGB&) = &LedsLayer::writePixelColor;
+  CRGB (LedsLayer::*readPixelColorCached)(int) const = &LedsLayer::readPixelColor;
+
+  //palette mode: the layer stores palette index and brightness per virtual pixel instead of rgb
+  //  ledsPal replaces ledsV and ledsL (2 instead of 3 bytes per pixel), resolved in ledsP at composite time
+  //  so a palette change also recolors pixels not redrawn. rgb writes keep the index and only set the brightness
+  struct PalPixel {
+    uint8_t index;
+    uint8_t bri; //0 is black
+  };
+  bool paletteMode = false;
+  PalPixel *ledsPal = nullptr;
+  uint16_t nrOfLedsPal = 0;
+  CRGB *paletteLUT = nullptr; //256 colors of paletteLUTSource
+  CRGBPalette16 paletteLUTSource;
+
+  std::vector<CRGB> spanColors; //span API scratch buffers
+  std::vector<uint8_t> spanIndexes;
+  struct Fragment {
+    int indexV;
+    uint8_t coverage; //255 is a plain write
+  };
+  std::vector<Fragment> fragments; //of the rasterizer, until composited
+
+  uint8_t virtualMode = vm_auto;
+  CRGB *ledsV = nullptr; //full color unmapped virtual pixels if allocated
+  uint16_t nrOfLedsV = 0;
   uint16_t mappingTableSizeUsed = 0;
   std::vector<std::vector<uint16_t>> mappingTableIndexes;
   uint16_t mappingTableIndexesSizeUsed = 0;
@@ -223,6 +564,18 @@ public:
 
   CRGBPalette16 palette;
 
+  Transition transition;
+
+  //time column of the layers table, reset each second
+  unsigned long loopMicros = 0; //time spent in effect and projection loop since last report
+  uint16_t loopFrames = 0;
+
+  //compositing, only used if more then one layer or opacity < 255
+  uint8_t opacity = 255;
+  uint8_t blendMode = bm_alpha;
+  std::vector<uint16_t> indexesP; //physical pixels of the layer
+  CRGB *ledsL = nullptr; //the layer's own pixels in indexesP order
+
   #ifdef STARBASE_USERMOD_LIVE
     uint8_t liveEffectID = UINT8_MAX;
   #endif
@@ -247,6 +600,7 @@ public:
 
   ~LedsLayer() {
     ppf("LedsLayer destructor\n");
+    releasePalettePixels(); //so fadeToBlackBy clears ledsP
     fadeToBlackBy();
     doMap = true; // so loop is not running while deleting
     for (std::vector<uint16_t> mappingTableIndex: mappingTableIndexes) {
@@ -254,10 +608,21 @@ public:
     }
     mappingTableIndexes.clear();
     mappingTable.clear();
+    mappingTableWide.clear();
+    releaseLayerPixels();
+    releaseVirtualPixels();
+    releasePalettePixels();
   }
 
   void triggerMapping();
 
+  //runs Effect::resize with a fresh effectCache
+  void resizeEffect() {
+    doResize = false;
+    effectCache.clear();
+    if (effect) effect->resize(*this);
+  }
+
   //set in operator[], used by other operators
   uint16_t operatorIndexV = 0;
   CRGB operatorCRGB;
@@ -326,19 +691,57 @@ public:
 
 
   // maps the virtual led to the physical led(s) and assign a color to it
-  void setPixelColor(int indexV, const CRGB& color);
+  void setPixelColor(int indexV, const CRGB& color) {
+    (this->*writePixelColorCached)(indexV, color);
+  }
+  void writePixelColor(int indexV, const CRGB& color);
+  void writePixelContiguous(int indexV, const CRGB& color);
+  void writePixelOneToOne(int indexV, const CRGB& color);
+  void writePixelOneToOneWide(int indexV, const CRGB& color);
+  void writePixelPal(int indexV, const CRGB& color);
   void setPixelColor(int x, int y, const CRGB& color) {setPixelColor(XYZ(x, y, 0), color);}
   void setPixelColor(int x, int y, int z, const CRGB& color) {setPixelColor(XYZ(x, y, z), color);}
   void setPixelColor(const Coord3D &pixel, const CRGB& color) {setPixelColor(XYZ(pixel), color);}
 
-  // temp methods until all effects have been converted to Palette / 2 byte mapping mode
+  //distance and angle to center2 / 2 of the pixels in fieldSize (default the layer)
+  //  cached per (fieldSize, center2) and shared: only built if no effect or projection built it before
+  const RadialField &radial(const Coord3D &center2, const Coord3D &fieldSize, uint8_t user = RadialField::byEffect);
+  const RadialField &radial(const Coord3D &center2) {return radial(center2, size);}
+  //user (byEffect or byProjection) stops using its fields, they stay cached for a next user
+  void releaseRadial(uint8_t user) {for (RadialField &field: radialFields) field.users &= ~user;}
+
+  //span API: projection and mapping resolved once per span instead of per pixel (per pixel if the projection has XYZ)
+  //colors in x, y, z order, use spanBuffer / spanIndexBuffer as scratch buffer
+  CRGB *spanBuffer(uint16_t length) {
+    if (spanColors.size() < length) spanColors.resize(length);
+    return spanColors.data();
+  }
+  uint8_t *spanIndexBuffer(uint16_t length) {
+    if (spanIndexes.size() < length) spanIndexes.resize(length);
+    return spanIndexes.data();
+  }
+  void writeSpan(int indexV, const CRGB *colors, uint16_t count); //consecutive virtual pixels (no XYZ)
+  void writeSpanPal(int indexV, const uint8_t *palIndexes, uint16_t count);
+  void writeRow(int y, const CRGB *colors, int z = 0); //size.x colors
+  void writeRowPal(int y, const uint8_t *palIndexes, int z = 0);
+  void writeColumn(int x, const CRGB *colors, int z = 0); //size.y colors
+  void writeBlock3D(const Coord3D &from, const Coord3D &to, const CRGB *colors); //from and to inclusive
+
+  //palette effects: stored as is in palette mode, else resolved by ColorFromPalette
   void setPixelColorPal(int indexV, uint8_t palIndex, uint8_t palBri = 255);
   void setPixelColorPal(const Coord3D &pixel, const uint8_t palIndex, const uint8_t palBri = 255) {setPixelColorPal(XYZ(pixel), palIndex, palBri);}
 
   void blendPixelColor(int indexV, const CRGB& color, uint8_t blendAmount);
   void blendPixelColor(const Coord3D &pixel, const CRGB& color, const uint8_t blendAmount) {blendPixelColor(XYZ(pixel), color, blendAmount);}
 
-  CRGB getPixelColor(int indexV) const;
+  CRGB getPixelColor(int indexV) const {
+    return (this->*readPixelColorCached)(indexV);
+  }
+  CRGB readPixelColor(int indexV) const;
+  CRGB readPixelContiguous(int indexV) const;
+  CRGB readPixelOneToOne(int indexV) const;
+  CRGB readPixelOneToOneWide(int indexV) const;
+  CRGB readPixelPal(int indexV) const;
   CRGB getPixelColor(int x, int y) {return getPixelColor(XYZ(x, y, 0));} //not const because of XYZ ...
   CRGB getPixelColor(int x, int y, int z) {return getPixelColor(XYZ(x, y, z));}
   CRGB getPixelColor(const Coord3D &pixel) {return getPixelColor(XYZ(pixel));}
@@ -352,11 +755,57 @@ public:
   void fill_solid(const CRGB& color);
   void fill_rainbow(uint8_t initialhue, uint8_t deltahue);
 
+  //list of all physical pixels of the layer (mapped pixels or all leds if no projection), sorted, each pixel once
+  void physicalPixels(std::vector<uint16_t> &indexesP) const;
+
+  //ledsL <-> ledsP, so the effect can render in ledsP as if it is the only layer (not in palette mode)
+  bool restoreLayerPixels();
+  void storeLayerPixels();
+  void releaseLayerPixels();
+  //blend ledsL (or ledsPal) onto ledsP using blendMode and opacity
+  void composite();
+
+  //ledsV for nrOfColor unmapped pixels, depending on virtualMode
+  void allocVirtualPixels(uint16_t nrOfColor);
+  void releaseVirtualPixels();
+
+  //unmapped pixels (ledsV or compact colors) of the outgoing effect in the transition, the incoming effect starts from black
+  size_t transitionPixelBytes() const;
+  bool allocTransitionPixels();
+  void swapTransitionPixels(); //before and after the outgoing effect loop
+  template <typename PhysMapT> uint16_t nrOfCompactColors(const std::vector<PhysMapT> &table) const;
+  template <typename PhysMapT> void swapCompactColors(std::vector<PhysMapT> &table);
+
+  //set mapShape and the cached set and get after mapping
+  void classifyMapping(uint16_t nrOfColor, uint16_t nrOfPhysicalM);
+  template <typename PhysMapT> bool isContiguous(const std::vector<PhysMapT> &table) const;
+
+  //ledsPal for all virtual pixels if paletteMode
+  void allocPalettePixels(uint16_t nrOfVirtual);
+  void releasePalettePixels();
+  //ledsPal through the palette onto the physical pixels, palette lookup table only rebuilt if the palette changed
+  void resolvePalettePixels();
+  template <typename PhysMapT> void resolveMapped(const PhysMapT &physMap, const CRGB &color);
+
+  //mapping, virtual pixels, layer pixels, transition and shared data
+  size_t bytesAllocated() const;
+
   //checks if a virtual pixel is mapped to a physical pixel (use with XY() or XYZ() to get the indexV)
   bool isMapped(int indexV) const {
-    return indexV < mappingTableSizeUsed && (mappingTable[indexV].mapType == m_onePixel || mappingTable[indexV].mapType == m_morePixels);
+    if (indexV >= mappingTableSizeUsed) return false;
+    uint8_t mapType = wideMapping?mappingTableWide[indexV].mapType:mappingTable[indexV].mapType;
+    return mapType == m_onePixel || mapType == m_morePixels;
   }
 
+  //per PhysMap variant, defined in LedLayer.cpp
+  template <typename PhysMapT> void setMappedColor(PhysMapT &physMap, const CRGB& color);
+  template <typename PhysMapT> void assignVirtualPixels(std::vector<PhysMapT> &table);
+  template <typename PhysMapT> CRGB getMappedColor(const PhysMapT &physMap) const;
+  template <typename PhysMapT> void addMappedIndexesP(const PhysMapT &physMap, std::vector<uint16_t> &indexesP) const;
+  template <typename PhysMapT> void resetMappingTable(std::vector<PhysMapT> &table);
+  template <typename PhysMapT> void addMapping(std::vector<PhysMapT> &table, uint16_t indexV, uint16_t indexP);
+  template <typename PhysMapT> void completeMappingTable(std::vector<PhysMapT> &table, uint16_t &nrOfPhysical, uint16_t &nrOfPhysicalM, uint16_t &nrOfColor);
+
   void blur1d(fract8 blur_amount)
   {
     const uint8_t keep = 255 - blur_amount;
@@ -426,242 +875,45 @@ public:
       }
   }
 
-  //to do: merge with drawLine to support 2D and 3D
-  void drawLine3D(int x1, int y1, int z1, int x2, int y2, int z2, CRGB color, bool soft = false, uint8_t depth = UINT8_MAX)
-  {
-        // WLEDMM shorten line according to depth
-    if (depth < UINT8_MAX) {
-      if (depth == 0) return;         // nothing to paint
-      if (depth<2) {x2 = x1; y2=y1; z2=z1;} // single pixel
-      else {                          // shorten line
-        x1 *=2; y1 *=2; z1 *=2; // we do everything "*2" for better rounding
-        int dx1 = ((int(2*x2) - int(x1)) * int(depth)) / 255;  // X distance, scaled down by depth 
-        int dy1 = ((int(2*y2) - int(y1)) * int(depth)) / 255;  // Y distance, scaled down by depth
-        int dz1 = ((int(2*z2) - int(z1)) * int(depth)) / 255;  // Y distance, scaled down by depth
-        x1 = (x1 + dx1 +1) / 2;
-        y1 = (y1 + dy1 +1) / 2;
-        z1 = (z1 + dz1 +1) / 2;
-        x1 /=2; y1 /=2; z1 /=2;
-      }
-    }
+  //rasterizer: primitives add coverage fragments (clipped, XYZ once per fragment), compositeFragments blends them in one pass
+  //  several primitives in the same color can be rasterized before one composite
+  //  depth < UINT8_MAX shortens a line to depth / 255 of its length (WLEDMM)
+  void rasterLine(int x0, int y0, int x1, int y1, bool soft = false, uint8_t depth = UINT8_MAX);
+  void rasterLine3D(int x0, int y0, int z0, int x1, int y1, int z1, bool soft = false, uint8_t depth = UINT8_MAX);
+  void rasterCircle(int cx, int cy, uint8_t radius, bool soft = false);
+  void rasterPolygon(const Coord3D *points, uint8_t count, bool filled = false, bool soft = false); //closed, z ignored
+  void rasterPoint(float x, float y, float z = 0); //anti-aliased over the 2 (2D) or 4 (3D) nearest pixels per axis
+  void compositeFragments(const CRGB &color); //full coverage runs are written as spans
+  void addFragment(int x, int y, int z, uint8_t coverage); //out of bounds and coverage 0 are skipped
 
-    //to do implement soft
-
-    //Bresenham
-    setPixelColor(x1, y1, z1, color);
-    int dx = abs(x2 - x1);
-    int dy = abs(y2 - y1);
-    int dz = abs(z2 - z1);
-    int xs;
-    int ys;
-    int zs;
-    if (x2 > x1)
-      xs = 1;
-    else
-      xs = -1;
-    if (y2 > y1)
-      ys = 1;
-    else
-      ys = -1;
-    if (z2 > z1)
-      zs = 1;
-    else
-      zs = -1;
-  
-    // Driving axis is X-axis"
-    if (dx >= dy && dx >= dz) {
-      int p1 = 2 * dy - dx;
-      int p2 = 2 * dz - dx;
-      while (x1 != x2) {
-        x1 += xs;
-        if (p1 >= 0) {
-          y1 += ys;
-          p1 -= 2 * dx;
-        }
-        if (p2 >= 0) {
-          z1 += zs;
-          p2 -= 2 * dx;
-        }
-        p1 += 2 * dy;
-        p2 += 2 * dz;
-        setPixelColor(x1, y1, z1, color);
-      }
-  
-      // Driving axis is Y-axis"
-    }
-    else if (dy >= dx && dy >= dz) {
-      int p1 = 2 * dx - dy;
-      int p2 = 2 * dz - dy;
-      while (y1 != y2) {
-        y1 += ys;
-        if (p1 >= 0) {
-          x1 += xs;
-          p1 -= 2 * dy;
-        }
-        if (p2 >= 0) {
-          z1 += zs;
-          p2 -= 2 * dy;
-        }
-        p1 += 2 * dx;
-        p2 += 2 * dz;
-        setPixelColor(x1, y1, z1, color);
-      }
-  
-      // Driving axis is Z-axis"
-    }
-    else {
-      int p1 = 2 * dy - dz;
-      int p2 = 2 * dx - dz;
-      while (z1 != z2) {
-        z1 += zs;
-        if (p1 >= 0) {
-          y1 += ys;
-          p1 -= 2 * dz;
-        }
-        if (p2 >= 0) {
-          x1 += xs;
-          p2 -= 2 * dz;
-        }
-        p1 += 2 * dy;
-        p2 += 2 * dx;
-        setPixelColor(x1, y1, z1, color);
-      }
-    }
+  void drawLine3D(int x1, int y1, int z1, int x2, int y2, int z2, CRGB color, bool soft = false, uint8_t depth = UINT8_MAX) {
+    rasterLine3D(x1, y1, z1, x2, y2, z2, soft, depth);
+    compositeFragments(color);
   }
- 
   void drawLine(int x0, int y0, int x1, int y1, CRGB color, bool soft = false, uint8_t depth = UINT8_MAX) {
-
-    // WLEDMM shorten line according to depth
-    if (depth < UINT8_MAX) {
-      if (depth == 0) return;         // nothing to paint
-      if (depth<2) {x1 = x0; y1=y0; } // single pixel
-      else {                          // shorten line
-        x0 *=2; y0 *=2; // we do everything "*2" for better rounding
-        int dx1 = ((int(2*x1) - int(x0)) * int(depth)) / 255;  // X distance, scaled down by depth 
-        int dy1 = ((int(2*y1) - int(y0)) * int(depth)) / 255;  // Y distance, scaled down by depth
-        x1 = (x0 + dx1 +1) / 2;
-        y1 = (y0 + dy1 +1) / 2;
-        x0 /=2; y0 /=2;
-      }
-    }
-
-    const int16_t dx = abs(x1-x0), sx = x0<x1 ? 1 : -1;
-    const int16_t dy = abs(y1-y0), sy = y0<y1 ? 1 : -1;
-
-    // single pixel (line length == 0)
-    if (dx+dy == 0) {
-      setPixelColor(x0, y0, 0, color);
-      return;
-    }
-
-    if (soft) {
-      // Xiaolin Wu’s algorithm
-      const bool steep = dy > dx;
-      if (steep) {
-        // we need to go along longest dimension
-        std::swap(x0,y0);
-        std::swap(x1,y1);
-      }
-      if (x0 > x1) {
-        // we need to go in increasing fashion
-        std::swap(x0,x1);
-        std::swap(y0,y1);
-      }
-      float gradient = x1-x0 == 0 ? 1.0f : float(y1-y0) / float(x1-x0);
-      float intersectY = y0;
-      for (int x = x0; x <= x1; x++) {
-        unsigned keep = float(0xFFFF) * (intersectY-int(intersectY)); // how much color to keep
-        unsigned seep = 0xFFFF - keep; // how much background to keep
-        int y = int(intersectY);
-        if (steep) std::swap(x,y);  // temporarily swap if steep
-        // pixel coverage is determined by fractional part of y co-ordinate
-        // WLEDMM added out-of-bounds check: "unsigned(x) < cols" catches negative numbers _and_ too large values
-        setPixelColor(x, y, 0, blend(color, getPixelColor(x, y, 0), keep));
-        int xx = x+int(steep);
-        int yy = y+int(!steep);
-        setPixelColor(xx, yy, 0, blend(color, getPixelColor(xx, yy, 0), seep));
-      
-        intersectY += gradient;
-        if (steep) std::swap(x,y);  // restore if steep
-      }
-    } else {
-      // Bresenham's algorithm
-      int err = (dx>dy ? dx : -dy)/2;   // error direction
-      for (;;) {
-        // if (x0 >= cols || y0 >= rows) break; // WLEDMM we hit the edge - should never happen
-        setPixelColor(x0, y0, 0, color);
-        if (x0==x1 && y0==y1) break;
-        int e2 = err;
-        if (e2 >-dx) { err -= dy; x0 += sx; }
-        if (e2 < dy) { err += dx; y0 += sy; }
-      }
-    }
+    rasterLine(x0, y0, x1, y1, soft, depth);
+    compositeFragments(color);
   }
-
   void drawCircle(int cx, int cy, uint8_t radius, CRGB col, bool soft) {
-    if (radius == 0) return;
-    if (soft) {
-      // Xiaolin Wu’s algorithm
-      int rsq = radius*radius;
-      int x = 0;
-      int y = radius;
-      unsigned oldFade = 0;
-      while (x < y) {
-        float yf = sqrtf(float(rsq - x*x)); // needs to be floating point
-        unsigned fade = float(0xFFFF) * (ceilf(yf) - yf); // how much color to keep
-        if (oldFade > fade) y--;
-        oldFade = fade;
-        setPixelColor(XY(cx+x, cy+y), blend(col, getPixelColor(XY(cx+x, cy+y)), fade));
-        setPixelColor(XY(cx-x, cy+y), blend(col, getPixelColor(XY(cx-x, cy+y)), fade));
-        setPixelColor(XY(cx+x, cy-y), blend(col, getPixelColor(XY(cx+x, cy-y)), fade));
-        setPixelColor(XY(cx-x, cy-y), blend(col, getPixelColor(XY(cx-x, cy-y)), fade));
-        setPixelColor(XY(cx+y, cy+x), blend(col, getPixelColor(XY(cx+y, cy+x)), fade));
-        setPixelColor(XY(cx-y, cy+x), blend(col, getPixelColor(XY(cx-y, cy+x)), fade));
-        setPixelColor(XY(cx+y, cy-x), blend(col, getPixelColor(XY(cx+y, cy-x)), fade));
-        setPixelColor(XY(cx-y, cy-x), blend(col, getPixelColor(XY(cx-y, cy-x)), fade));
-        setPixelColor(XY(cx+x, cy+y-1), blend(getPixelColor(XY(cx+x, cy+y-1)), col, fade));
-        setPixelColor(XY(cx-x, cy+y-1), blend(getPixelColor(XY(cx-x, cy+y-1)), col, fade));
-        setPixelColor(XY(cx+x, cy-y+1), blend(getPixelColor(XY(cx+x, cy-y+1)), col, fade));
-        setPixelColor(XY(cx-x, cy-y+1), blend(getPixelColor(XY(cx-x, cy-y+1)), col, fade));
-        setPixelColor(XY(cx+y-1, cy+x), blend(getPixelColor(XY(cx+y-1, cy+x)), col, fade));
-        setPixelColor(XY(cx-y+1, cy+x), blend(getPixelColor(XY(cx-y+1, cy+x)), col, fade));
-        setPixelColor(XY(cx+y-1, cy-x), blend(getPixelColor(XY(cx+y-1, cy-x)), col, fade));
-        setPixelColor(XY(cx-y+1, cy-x), blend(getPixelColor(XY(cx-y+1, cy-x)), col, fade));
-        x++;
-      }
-    } else {
-      // Bresenham’s Algorithm
-      int d = 3 - (2*radius);
-      int y = radius, x = 0;
-      while (y >= x) {
-        setPixelColor(XY(cx+x, cy+y), col);
-        setPixelColor(XY(cx-x, cy+y), col);
-        setPixelColor(XY(cx+x, cy-y), col);
-        setPixelColor(XY(cx-x, cy-y), col);
-        setPixelColor(XY(cx+y, cy+x), col);
-        setPixelColor(XY(cx-y, cy+x), col);
-        setPixelColor(XY(cx+y, cy-x), col);
-        setPixelColor(XY(cx-y, cy-x), col);
-        x++;
-        if (d > 0) {
-          y--;
-          d += 4 * (x - y) + 10;
-        } else {
-          d += 4 * x + 6;
-        }
-      }
-    }
+    rasterCircle(cx, cy, radius, soft);
+    compositeFragments(col);
+  }
+  void drawPolygon(const Coord3D *points, uint8_t count, CRGB col, bool filled = false, bool soft = false) {
+    rasterPolygon(points, count, filled, soft);
+    compositeFragments(col);
   }
 
   //shift is used by drawText indicating which letter it is drawing
   void drawCharacter(unsigned char chr, int x = 0, int y = 0, uint8_t font = 0, CRGB col = CRGB::Red, uint16_t shiftPixel = 0, uint16_t shiftChr = 0);
 
-  void drawText(const char * text, int x = 0, int y = 0, uint8_t font = 0, CRGB col = CRGB::Red, uint16_t shiftPixel = 0) {
-    const int numberOfChr = text?strnlen(text, 256):0; //max 256 charcters
-    for (int shiftChr = 0; shiftChr < numberOfChr; shiftChr++) {
-      drawCharacter(text[shiftChr], x, y, font, col, shiftPixel, shiftChr);
-    }
-  }
+  //text is rasterized once (see textBitmaps) and blitted, wrapping around size.x
+  void drawText(const char * text, int x = 0, int y = 0, uint8_t font = 0, CRGB col = CRGB::Red, uint16_t shiftPixel = 0);
+
+  //set bits of the bitmap in col, each bit a scale x scale block, runs of bits are written as spans
+  //  wrapX: x wraps around size.x, otherwise clipped
+  void blit(const Bitmap &bitmap, int x, int y, CRGB col, uint8_t scale = 1, bool wrapX = false);
+  //width x height sprite of color indexes (x order), index transparent is not drawn
+  void blitSprite(const uint8_t *indexes, int width, int height, const CRGB *colors, int x, int y, uint8_t transparent = UINT8_MAX);
 
   void addPixelsPre(uint8_t rowNr);
   void addPixel(Coord3D pixel, uint8_t rowNr);
@@ -675,25 +927,23 @@ public:
 //128: 128, 1      0 -32645
 //192: 1, 127      -32645 0
 
-static unsigned trigoCached = 1;
-static unsigned trigoUnCached = 1;
-
 struct Trigo {
   virtual ~Trigo() = default;
 
   uint16_t period = 360; //default period 360
   Trigo(uint16_t period = 360) {this->period = period;}
-  float sinValue[3]; uint16_t sinAngle[3] = {UINT16_MAX,UINT16_MAX,UINT16_MAX}; //caching of sinValue=sin(sinAngle) for tilt, pan and roll
-  float cosValue[3]; uint16_t cosAngle[3] = {UINT16_MAX,UINT16_MAX,UINT16_MAX}; //caching of cosValue=cos(cosAngle) for tilt, pan and roll
-  virtual float sinBase(uint16_t angle) {return sinf(M_TWOPI * angle / period);}
-  virtual float cosBase(uint16_t angle) {return cosf(M_TWOPI * angle / period);}
+  int16_t sinValue[3]; uint16_t sinAngle[3] = {UINT16_MAX,UINT16_MAX,UINT16_MAX}; //caching of sinValue=sin(sinAngle) for tilt, pan and roll
+  int16_t cosValue[3]; uint16_t cosAngle[3] = {UINT16_MAX,UINT16_MAX,UINT16_MAX}; //caching of cosValue=cos(cosAngle) for tilt, pan and roll
+  uint16_t binaryAngle(uint16_t angle) const {return period?(uint32_t)(angle % period) * 65536 / period:0;}
+  virtual int16_t sinBase(uint16_t angle) {return sinQ15(binaryAngle(angle));}
+  virtual int16_t cosBase(uint16_t angle) {return cosQ15(binaryAngle(angle));}
   int16_t sin(int16_t factor, uint16_t angle, uint8_t cache012 = 0) {
-    if (sinAngle[cache012] != angle) {sinAngle[cache012] = angle; sinValue[cache012] = sinBase(angle);trigoUnCached++;} else trigoCached++;
-    return factor * sinValue[cache012];
+    if (sinAngle[cache012] != angle) {sinAngle[cache012] = angle; sinValue[cache012] = sinBase(angle);}
+    return mulQ15(factor, sinValue[cache012]);
   };
   int16_t cos(int16_t factor, uint16_t angle, uint8_t cache012 = 0) {
-    if (cosAngle[cache012] != angle) {cosAngle[cache012] = angle; cosValue[cache012] = cosBase(angle);trigoUnCached++;} else trigoCached++;
-    return factor * cosValue[cache012];
+    if (cosAngle[cache012] != angle) {cosAngle[cache012] = angle; cosValue[cache012] = cosBase(angle);}
+    return mulQ15(factor, cosValue[cache012]);
   };
   // https://msl.cs.uiuc.edu/planning/node102.html
   Coord3D pan(Coord3D in, Coord3D middle, uint16_t angle) {
@@ -728,13 +978,13 @@ struct Trigo {
 
 struct Trigo8: Trigo { //FastLed sin8 and cos8
   using Trigo::Trigo;
-  float sinBase(uint16_t angle) override {return (sin8(256.0f * angle / period) - 128) / 127.0f;}
-  float cosBase(uint16_t angle) override {return (cos8(256.0f * angle / period) - 128) / 127.0f;}
+  int16_t sinBase(uint16_t angle) override {return (sin8(binaryAngle(angle) >> 8) - 128) * 258;}
+  int16_t cosBase(uint16_t angle) override {return (cos8(binaryAngle(angle) >> 8) - 128) * 258;}
 };
 struct Trigo16: Trigo { //FastLed sin16 and cos16
   using Trigo::Trigo;
-  float sinBase(uint16_t angle) override {return sin16(65536.0f * angle / period) / 32645.0f;}
-  float cosBase(uint16_t angle) override {return cos16(65536.0f * angle / period) / 32645.0f;}
+  int16_t sinBase(uint16_t angle) override {return sin16(binaryAngle(angle));}
+  int16_t cosBase(uint16_t angle) override {return cos16(binaryAngle(angle));}
 };
 
 static Trigo trigoTiltPanRoll(255); // Trigo8 is hardly any faster (27 vs 28 fps) (spanXY=28)
\ No newline at end of file
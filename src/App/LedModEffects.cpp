@@ -200,6 +200,8 @@ inline uint16_t getRGBWsize(uint16_t nleds){
           uint16_t effectNr = variable.getValue(rowNr);
 
           if (effectNr < effects.size()) {
+            if (leds->effect && effects[effectNr]->dim() == leds->effectDimension) //no remap needed
+              startTransition(*leds);
             leds->effect = effects[effectNr];
             ppf("setEffect effect[%d]: %s\n", rowNr, leds->effect->name());
             strlcat(fix->tickerTape, leds->effect->name(), sizeof(fix->tickerTape));
@@ -280,7 +282,7 @@ inline uint16_t getRGBWsize(uint16_t nleds){
     }});
     currentVar.var["dash"] = true;
 
-    ui->initCoord3D(tableVar, "start", {0,0,0}, 0, STARLIGHT_MAXLEDS, false, [this](EventArguments) { switch (eventType) {
+    ui->initCoord3D(tableVar, "start", {0,0,0}, 0, UINT16_MAX, false, [this](EventArguments) { switch (eventType) {
       case onSetValue:
         //is this needed?
         for (size_t rowNr = 0; rowNr < fix->layers.size(); rowNr++) {
@@ -307,7 +309,7 @@ inline uint16_t getRGBWsize(uint16_t nleds){
       default: return false;
     }});
 
-    ui->initCoord3D(tableVar, "middle", {0,0,0}, 0, STARLIGHT_MAXLEDS, false, [this](EventArguments) { switch (eventType) {
+    ui->initCoord3D(tableVar, "middle", {0,0,0}, 0, UINT16_MAX, false, [this](EventArguments) { switch (eventType) {
       case onSetValue:
         //is this needed?
         for (size_t rowNr = 0; rowNr < fix->layers.size(); rowNr++) {
@@ -334,7 +336,7 @@ inline uint16_t getRGBWsize(uint16_t nleds){
       default: return false;
     }});
 
-    ui->initCoord3D(tableVar, "end", {8,8,0}, 0, STARLIGHT_MAXLEDS, false, [this](EventArguments) { switch (eventType) {
+    ui->initCoord3D(tableVar, "end", {8,8,0}, 0, UINT16_MAX, false, [this](EventArguments) { switch (eventType) {
       case onSetValue:
         //is this needed?
         for (size_t rowNr = 0; rowNr < fix->layers.size(); rowNr++) {
@@ -361,6 +363,83 @@ inline uint16_t getRGBWsize(uint16_t nleds){
       default: return false;
     }});
 
+    ui->initSlider(tableVar, "opacity", 255, 0, 255, false, [this](EventArguments) { switch (eventType) {
+      case onSetValue:
+        for (size_t rowNr = 0; rowNr < fix->layers.size(); rowNr++)
+          variable.setValue(fix->layers[rowNr]->opacity, rowNr);
+        return true;
+      case onUI:
+        variable.setComment("Of the layer on the layers below it");
+        return true;
+      case onChange:
+        if (rowNr < fix->layers.size())
+          fix->layers[rowNr]->opacity = variable.getValue(rowNr);
+        return true;
+      default: return false;
+    }});
+
+    ui->initSelect(tableVar, "blend", (uint8_t)bm_alpha, false, [this](EventArguments) { switch (eventType) {
+      case onSetValue:
+        for (size_t rowNr = 0; rowNr < fix->layers.size(); rowNr++)
+          variable.setValue(fix->layers[rowNr]->blendMode, rowNr);
+        return true;
+      case onUI: {
+        variable.setComment("How the layer is combined with the layers below it");
+        JsonArray options = variable.setOptions();
+        options.add("Alpha"); //0
+        options.add("Add"); //1
+        options.add("Multiply"); //2
+        options.add("Screen"); //3
+        options.add("Max"); //4
+        return true; }
+      case onChange:
+        if (rowNr < fix->layers.size()) {
+          uint8_t blendMode = variable.getValue(rowNr);
+          fix->layers[rowNr]->blendMode = blendMode < bm_count?blendMode:bm_alpha;
+        }
+        return true;
+      default: return false;
+    }});
+
+    ui->initSelect(tableVar, "virtual", (uint8_t)vm_auto, false, [this](EventArguments) { switch (eventType) {
+      case onSetValue:
+        for (size_t rowNr = 0; rowNr < fix->layers.size(); rowNr++)
+          variable.setValue(fix->layers[rowNr]->virtualMode, rowNr);
+        return true;
+      case onUI: {
+        variable.setComment("Colors of virtual pixels not on the fixture");
+        JsonArray options = variable.setOptions();
+        options.add("Auto"); //0
+        options.add("Compact"); //1
+        options.add("Full"); //2
+        return true; }
+      case onChange:
+        if (rowNr < fix->layers.size()) {
+          uint8_t virtualMode = variable.getValue(rowNr);
+          fix->layers[rowNr]->virtualMode = virtualMode < vm_count?virtualMode:vm_auto;
+          fix->layers[rowNr]->triggerMapping();
+        }
+        return true;
+      default: return false;
+    }});
+
+    ui->initCheckBox(tableVar, "indexed", false, false, [this](EventArguments) { switch (eventType) {
+      case onSetValue:
+        for (size_t rowNr = 0; rowNr < fix->layers.size(); rowNr++)
+          variable.setValue(fix->layers[rowNr]->paletteMode, rowNr);
+        return true;
+      case onUI:
+        variable.setComment("Palette index and brightness per pixel instead of rgb (2 B instead of 3), recolors on palette change");
+        return true;
+      case onChange:
+        if (rowNr < fix->layers.size()) {
+          fix->layers[rowNr]->paletteMode = variable.getValue(rowNr);
+          fix->layers[rowNr]->triggerMapping();
+        }
+        return true;
+      default: return false;
+    }});
+
     ui->initText(tableVar, "size", nullptr, 32, true, [this](EventArguments) { switch (eventType) {
       case onSetValue: {
         // for (std::vector<LedsLayer *>::iterator leds=fix->layers.begin(); leds!=fix->layers.end(); ++leds) {
@@ -376,6 +455,34 @@ inline uint16_t getRGBWsize(uint16_t nleds){
       default: return false;
     }});
 
+    ui->initText(tableVar, "memory", nullptr, 32, true, [this](EventArguments) { switch (eventType) {
+      case onLoop1s: {
+        uint8_t rowNr = 0;
+        for (LedsLayer *leds:fix->layers) {
+          StarString message;
+          message.format("%d B%s", leds->bytesAllocated(), leds->ledsV?" (full)":leds->ledsPal?" (indexed)":"");
+          variable.setValue(JsonString(message.getString()), rowNr);
+          rowNr++;
+        }
+        return true; }
+      default: return false;
+    }});
+
+    ui->initText(tableVar, "time", nullptr, 32, true, [this](EventArguments) { switch (eventType) {
+      case onLoop1s: {
+        uint8_t rowNr = 0;
+        for (LedsLayer *leds:fix->layers) {
+          StarString message;
+          message.format("%u µs", leds->loopFrames?(unsigned)(leds->loopMicros / leds->loopFrames):0); //per frame
+          variable.setValue(JsonString(message.getString()), rowNr);
+          leds->loopMicros = 0;
+          leds->loopFrames = 0;
+          rowNr++;
+        }
+        return true; }
+      default: return false;
+    }});
+
     // ui->initSelect(parentVar, "layout", 0, false, [](EventArguments) { switch (eventType) {
     //   case onUI: {
     //     variable.setComment("WIP");
@@ -389,7 +496,107 @@ inline uint16_t getRGBWsize(uint16_t nleds){
     //   default: return false;
     // }}); //effect Layout
 
-    ui->initSlider(parentVar, "Blending", &fix->globalBlend);
+    ui->initSelect(parentVar, "snapshot", (uint8_t)0, false, [this](EventArguments) { switch (eventType) {
+      case onUI: {
+        variable.setComment("Switch all layers at once");
+        JsonArray options = variable.setOptions();
+        for (uint8_t snapshotNr = 0; snapshotNr < nrOfSnapshots; snapshotNr++) {
+          StarString buf;
+          buf.format("%02d: ", snapshotNr);
+          if (snapshots[snapshotNr].empty())
+            buf += "Empty";
+          else {
+            for (const LayerSnapshot &layerSnapshot: snapshots[snapshotNr]) {
+              if (layerSnapshot.effectNr < effects.size()) buf += effects[layerSnapshot.effectNr]->name();
+              buf.catSep(", ");
+            }
+          }
+          options.add(buf.getString()); //copy!
+        }
+        return true; }
+      case onChange: {
+        uint8_t snapshotNr = variable.getValue();
+        if (snapshotNr < nrOfSnapshots && !snapshots[snapshotNr].empty()) //not at boot as snapshots are read at the end of setup
+          selectSnapshot(snapshotNr);
+        return true; }
+      default: return false;
+    }});
+
+    ui->initButton(parentVar, "capture", false, [this](EventArguments) { switch (eventType) {
+      case onUI:
+        variable.setComment("Store all layers in the selected snapshot");
+        return true;
+      case onChange: {
+        uint8_t snapshotNr = mdl->getValue(name, "snapshot");
+        captureSnapshot(snapshotNr);
+        writeSnapshots();
+        Variable(name, "snapshot").triggerEvent(onUI); //rebuild options
+        return true; }
+      default: return false;
+    }});
+
+    ui->initNumber(parentVar, "crossfade", &crossfadeMillis, 0, 10000, false, [](EventArguments) { switch (eventType) {
+      case onUI:
+        variable.setComment("ms, when switching snapshots");
+        return true;
+      default: return false;
+    }});
+
+    ui->initNumber(parentVar, "transition", &transitionMillis, 0, 10000, false, [](EventArguments) { switch (eventType) {
+      case onUI:
+        variable.setComment("ms, when switching effects");
+        return true;
+      default: return false;
+    }});
+
+    ui->initNumber(parentVar, "transitionMax", &transitionMaxKB, 0, 1024, false, [](EventArguments) { switch (eventType) {
+      case onUI:
+        variable.setComment("KB, hard cut if transitions need more");
+        return true;
+      default: return false;
+    }});
+
+    ui->initText(parentVar, "transitionMem", nullptr, 32, true, [this](EventArguments) { switch (eventType) {
+      case onLoop1s: {
+        uint8_t active = 0;
+        for (LedsLayer *leds: fix->layers) if (leds->transition.effect) active++;
+        variable.setValueF("%d active, %d B", active, transitionBytes());
+        return true; }
+      default: return false;
+    }});
+
+    ui->initSelect(parentVar, "recorder", (uint8_t)recorderOff, false, [this](EventArguments) { switch (eventType) {
+      case onUI: {
+        variable.setComment("Inputs of each frame in /recording.bin");
+        JsonArray options = variable.setOptions();
+        options.add("Off"); //recorderOff
+        options.add("Record"); //recorderRecord
+        options.add("Record with frames"); //recorderRecordFrames
+        options.add("Replay"); //recorderReplay
+        return true; }
+      case onChange: {
+        uint8_t mode = variable.getValue();
+        if (mode != recorderMode) selectRecorder(mode);
+        return true; }
+      default: return false;
+    }});
+
+    ui->initNumber(parentVar, "recordMax", &recordMaxKB, 1, 4096, false, [](EventArguments) { switch (eventType) {
+      case onUI:
+        variable.setComment("KB, recording stops if full");
+        return true;
+      default: return false;
+    }});
+
+    ui->initText(parentVar, "recording", nullptr, 32, true, [this](EventArguments) { switch (eventType) {
+      case onLoop1s:
+        if (recorderMode == recorderReplay)
+          variable.setValueF("%d frames, %d differ", recordFrames, replayDiffs);
+        else
+          variable.setValueF("%d frames", recordFrames);
+        return true;
+      default: return false;
+    }});
 
     addPresets(parentVar.var);
 
@@ -414,6 +621,8 @@ inline uint16_t getRGBWsize(uint16_t nleds){
 
     //for use in loop
     varSystem = mdl->findVar("m", "System");
+
+    readSnapshots();
   }
 
   //this loop is run as often as possible so coding should also be as efficient as possible (no findVar etc)
@@ -425,32 +634,66 @@ inline uint16_t getRGBWsize(uint16_t nleds){
     //set new frame
     if (sys->now - frameMillis >= 1000.0/fix->fps - 1 && fix->mappingStatus == 0) { //floorf to make it no wait to go beyond 1000 fps ;-)
 
-      //reset pixelsToBlend if multiple leds effects
-      // ppf(" %d-%d", fix->pixelsToBlend.size(), fix->nrOfLeds);
-      if (fix->layers.size() > 1) //if more then one effect
-        for (uint16_t indexP=0; indexP < fix->pixelsToBlend.size(); indexP++)
-          fix->pixelsToBlend[indexP] = false;
-
       frameMillis = sys->now;
 
       newFrame = true;
 
+      //switch snapshots at a frame boundary
+      if (pendingSnapshot != UINT8_MAX) {
+        applySnapshot(pendingSnapshot);
+        pendingSnapshot = UINT8_MAX;
+      }
+      //layers which needed a remap get their data after mapping and initEffect are done
+      if (pendingDataRows && doInitEffectRowNr == UINT8_MAX) {
+        for (uint8_t rowNr = 0; rowNr < fix->layers.size() && rowNr < pendingData->size(); rowNr++) {
+          if ((pendingDataRows & (1UL << rowNr)) && !fix->layers[rowNr]->doMap) {
+            applySnapshotData(*fix->layers[rowNr], rowNr, (*pendingData)[rowNr]);
+            pendingDataRows &= ~(1UL << rowNr);
+          }
+        }
+      }
+      //the recorder starts at a frame boundary after the snapshot data is applied
+      if (pendingRecorder != UINT8_MAX) {
+        uint8_t mode = pendingRecorder;
+        pendingRecorder = UINT8_MAX;
+        startRecorder(mode);
+      }
+      if (recorderMode == recorderReplay) replayFrameStart();
+      else if (recorderMode != recorderOff) recordFrameStart();
+
+      //layers render in their own pixels and are composited afterwards, a single opaque layer renders directly in ledsP
+      //  also during a snapshot crossfade: ledsP is blended with the old frame, effects reading back their pixels would fade themselves
+      bool compositing = fix->layers.size() > 1 || (fix->layers.size() == 1 && fix->layers[0]->opacity < 255) || fadeBuffer;
+
       //for each programmed effect
       //  run the next frame of the effect
       for (uint8_t rowNr = 0; rowNr < fix->layers.size(); rowNr++) {
         LedsLayer *leds = fix->layers[rowNr];
+        if (!compositing && leds->ledsL) leds->releaseLayerPixels();
         if (leds->effect && !leds->doMap) { // don't run effect while remapping or non existing effect (default UINT16_MAX)
+          bool layered = compositing && leds->restoreLayerPixels(); //if no memory: render directly in ledsP
           // ppf(" %s %d,%d,%d - %d,%d,%d (%d,%d,%d)", leds->effect->name(), leds->start.x, leds->start.y, leds->start.z, leds->end.x, leds->end.y, leds->end.z, leds->size.x, leds->size.y, leds->size.z );
 
-          leds->effectData.begin(); //sets the effectData pointer back to 0 so loop effect can go through it
-
           mdl->getValueRowNr = rowNr;
-          leds->effect->loop(*leds);
+          if (leds->doResize) leds->resizeEffect(); //remapped
+          unsigned long loopStart = micros();
+          if (leds->projection) {
+            leds->projectionData.begin();
+            (leds->projection->*leds->loopPreCached)(*leds);
+          }
+          if (leds->transition.effect)
+            loopTransition(*leds);
+          else {
+            leds->effectData.begin(); //sets the effectData pointer back to 0 so loop effect can go through it
+            leds->effect->loop(*leds);
+          }
           //using cached virtual class methods! (so no need for if projectionNr optimizations!)
           if (leds->projection) {
             leds->projectionData.begin();
             (leds->projection->*leds->loopCached)(*leds);
           }
+          leds->loopMicros += micros() - loopStart;
+          leds->loopFrames++;
           mdl->getValueRowNr = UINT8_MAX;
 
           if (fix->showTicker && rowNr == fix->layers.size() - 1) { //last effect, add sysinfo
@@ -465,20 +708,40 @@ inline uint16_t getRGBWsize(uint16_t nleds){
           // if (leds->projectionNr == p_TiltPanRoll || leds->projectionNr == p_Preset1)
           //   leds->fadeToBlackBy(50);
 
-          //loop over mapped pixels and set pixelsToBlend to true
-          if (fix->layers.size() > 1) { //if more then one effect
-            for (const std::vector<uint16_t>& mappingTableIndex: leds->mappingTableIndexes) {
-              for (const uint16_t indexP: mappingTableIndex)
-                fix->pixelsToBlend[indexP] = true;
-            }
-            for (const PhysMap &physMap: leds->mappingTable) {
-              if (physMap.mapType == m_onePixel)
-                fix->pixelsToBlend[physMap.indexP] = true;
-            }
-          }
+          if (layered) leds->storeLayerPixels();
+        }
+      }
+
+      //first layer at the bottom, pixels of no layer are black
+      if (compositing) {
+        memset((void *)fix->ledsP, 0, fix->nrOfLeds * sizeof(CRGB));
+        for (LedsLayer *leds: fix->layers)
+          if (leds->effect && !leds->doMap) leds->composite();
+      }
+      else //a palette layer is only in ledsPal
+        for (LedsLayer *leds: fix->layers)
+          if (leds->ledsPal && leds->effect && !leds->doMap) leds->composite();
+
+      //crossfade from the last frame before the snapshot switch
+      if (fadeBuffer) {
+        unsigned long elapsed = sys->now - fadeStart;
+        if (elapsed >= crossfadeMillis) {
+          free(fadeBuffer);
+          fadeBuffer = nullptr;
+        }
+        else {
+          uint8_t amountOld = 255 - elapsed * 255 / crossfadeMillis;
+          uint16_t length = min(fadeLength, fix->nrOfLeds);
+          for (uint16_t indexP = 0; indexP < length; indexP++)
+            fix->ledsP[indexP] = blend(fix->ledsP[indexP], fadeBuffer[indexP], amountOld);
         }
       }
 
+      if (recorderMode == recorderReplay) {
+        if (replayStarted) replayFrameEnd();
+      }
+      else if (recorderMode != recorderOff) recordFrameEnd();
+
       frameCounter++;
     }
     else {
@@ -526,8 +789,11 @@ inline uint16_t getRGBWsize(uint16_t nleds){
       ppf("initEffect leds[%d] effect:%s a:%d (%d,%d,%d)\n", rowNr, leds.effect->name(), leds.effectData.bytesAllocated, leds.size.x, leds.size.y, leds.size.z);
 
       leds.effectData.clear(); //delete effectData memory so it can be rebuild
+      leds.releaseRadial(RadialField::byEffect); //cached for a next effect using the same field
+      leds.resizeEffect(); //per size constants before the first loop
 
-      leds.effect->loop(leds); leds.effectData.begin(); //do a loop to set effectData right
+      leds.effectData.sizing = true; //first loop sizes effectData, then one allocation of the footprint
+      leds.effect->loop(leds); leds.effectData.fit(); leds.effectData.begin(); //do a loop to set effectData right
 
       Variable variable = Variable("layers", "effect");
       variable.preDetails();
@@ -540,3 +806,721 @@ inline uint16_t getRGBWsize(uint16_t nleds){
 
 
   }
+
+  void LedModEffects::startTransition(LedsLayer &leds) {
+    leds.transition.end(); //a running transition is cut
+
+    if (transitionMillis == 0 || fadeBuffer) return; //snapshots do their own crossfade
+    if (leds.ledsPal) return; //palette mode: both effects would draw in the same ledsPal, hard cut
+    #ifdef STARBASE_USERMOD_LIVE
+      if (strncmp(leds.effect->name(), "Live Effect", 12) == 0) return; //script already killed
+    #endif
+
+    leds.physicalPixels(leds.transition.indexesP);
+    size_t nrOfPixels = leds.transition.indexesP.size();
+    size_t bytesNeeded = nrOfPixels * (2 * sizeof(CRGB) + sizeof(uint16_t)) + leds.transitionPixelBytes();
+    if (nrOfPixels == 0 || transitionBytes() + bytesNeeded > transitionMaxKB * 1024) {
+      ppf("startTransition hard cut %d + %d B > %d KB\n", transitionBytes(), bytesNeeded, transitionMaxKB);
+      leds.transition.end();
+      return;
+    }
+
+    leds.transition.buffer = (CRGB *)malloc(2 * nrOfPixels * sizeof(CRGB));
+    if (!leds.transition.buffer) {
+      ppf("startTransition malloc failed %d B\n", 2 * nrOfPixels * sizeof(CRGB));
+      leds.transition.end();
+      return;
+    }
+    if (!leds.allocTransitionPixels()) {
+      leds.transition.end();
+      return;
+    }
+
+    //outgoing frame is what is shown now, incoming effect starts from black
+    CRGB *outgoing = leds.transition.buffer;
+    for (size_t i = 0; i < nrOfPixels; i++) outgoing[i] = fix->ledsP[leds.transition.indexesP[i]];
+    memset((void *)(outgoing + nrOfPixels), 0, nrOfPixels * sizeof(CRGB));
+
+    leds.transition.effect = leds.effect;
+    leds.transition.palette = leds.palette;
+    leds.transition.effectData.swap(leds.effectData); //initEffect will build new effectData
+    leds.transition.effectCache.swap(leds.effectCache);
+    leds.transition.start = sys->now;
+    ppf("startTransition %s %d ms %d B\n", leds.effect->name(), transitionMillis, leds.transition.bytesAllocated());
+  }
+
+  void LedModEffects::loopTransition(LedsLayer &leds) {
+    Transition &transition = leds.transition;
+    const std::vector<uint16_t> &indexesP = transition.indexesP;
+    const size_t nrOfPixels = indexesP.size();
+    CRGB *outgoing = transition.buffer;
+    CRGB *incoming = transition.buffer + nrOfPixels;
+
+    unsigned long elapsed = sys->now - transition.start;
+    if (elapsed >= transitionMillis) {
+      for (size_t i = 0; i < nrOfPixels; i++) fix->ledsP[indexesP[i]] = incoming[i];
+      transition.end();
+      leds.effectData.begin();
+      leds.effect->loop(leds);
+      return;
+    }
+
+    //outgoing effect with its own data and palette
+    for (size_t i = 0; i < nrOfPixels; i++) fix->ledsP[indexesP[i]] = outgoing[i];
+    leds.effectData.swap(transition.effectData);
+    leds.effectCache.swap(transition.effectCache);
+    std::swap(leds.palette, transition.palette);
+    leds.swapTransitionPixels();
+    leds.effectData.begin();
+    transition.effect->loop(leds);
+    leds.effectData.swap(transition.effectData);
+    leds.effectCache.swap(transition.effectCache);
+    std::swap(leds.palette, transition.palette);
+    leds.swapTransitionPixels();
+    for (size_t i = 0; i < nrOfPixels; i++) outgoing[i] = fix->ledsP[indexesP[i]];
+
+    //incoming effect
+    for (size_t i = 0; i < nrOfPixels; i++) fix->ledsP[indexesP[i]] = incoming[i];
+    leds.effectData.begin();
+    leds.effect->loop(leds);
+
+    uint8_t amountIncoming = elapsed * 255 / transitionMillis;
+    for (size_t i = 0; i < nrOfPixels; i++) {
+      CRGB &ledP = fix->ledsP[indexesP[i]];
+      incoming[i] = ledP;
+      ledP = blend(outgoing[i], incoming[i], amountIncoming);
+    }
+  }
+
+  size_t LedModEffects::transitionBytes() const {
+    size_t bytes = 0;
+    for (LedsLayer *leds: fix->layers) bytes += leds->transition.bytesAllocated();
+    return bytes;
+  }
+
+  void LedModEffects::captureSnapshot(uint8_t snapshotNr) {
+    if (snapshotNr >= nrOfSnapshots) return;
+    std::vector<LayerSnapshot> &snapshot = snapshots[snapshotNr];
+    snapshot.clear();
+
+    for (uint8_t rowNr = 0; rowNr < fix->layers.size() && rowNr < maxSnapshotLayers; rowNr++) {
+      LayerSnapshot layerSnapshot;
+      captureLayer(rowNr, layerSnapshot);
+      snapshot.push_back(layerSnapshot);
+    }
+    ppf("captureSnapshot %d: %d layers\n", snapshotNr, snapshot.size());
+  }
+
+  void LedModEffects::captureLayer(uint8_t rowNr, LayerSnapshot &layerSnapshot) {
+    LedsLayer *leds = fix->layers[rowNr];
+    layerSnapshot.effectNr = std::find(effects.begin(), effects.end(), leds->effect) - effects.begin();
+    layerSnapshot.projectionNr = leds->projection?std::find(projections.begin(), projections.end(), leds->projection) - projections.begin():0;
+    layerSnapshot.paletteNr = mdl->getValue("effect", "palette", rowNr);
+    layerSnapshot.start = mdl->getValue("layers", "start", rowNr);
+    layerSnapshot.middle = mdl->getValue("layers", "middle", rowNr);
+    layerSnapshot.end = mdl->getValue("layers", "end", rowNr);
+    if (leds->effectData.getData())
+      layerSnapshot.effectData.assign(leds->effectData.getData(), leds->effectData.getData() + leds->effectData.bytesAllocated);
+    if (leds->projectionData.getData())
+      layerSnapshot.projectionData.assign(leds->projectionData.getData(), leds->projectionData.getData() + leds->projectionData.bytesAllocated);
+  }
+
+  void LedModEffects::applySnapshot(uint8_t snapshotNr) {
+    if (snapshotNr >= nrOfSnapshots) return;
+    const std::vector<LayerSnapshot> &snapshot = snapshots[snapshotNr];
+    ppf("applySnapshot %d: %d layers\n", snapshotNr, snapshot.size());
+
+    if (crossfadeMillis) {
+      //keep the current frame to fade from
+      if (fadeBuffer == nullptr || fadeLength != fix->nrOfLeds) {
+        free(fadeBuffer);
+        fadeBuffer = (CRGB *)malloc(fix->nrOfLeds * sizeof(CRGB));
+      }
+      if (fadeBuffer) {
+        memcpy(fadeBuffer, fix->ledsP, fix->nrOfLeds * sizeof(CRGB));
+        fadeLength = fix->nrOfLeds;
+        fadeStart = sys->now;
+      }
+    }
+
+    applyLayers(snapshot);
+  }
+
+  void LedModEffects::applyLayers(const std::vector<LayerSnapshot> &layers) {
+    pendingData = &layers;
+    pendingDataRows = 0;
+
+    for (uint8_t rowNr = 0; rowNr < layers.size() && rowNr < maxSnapshotLayers; rowNr++) {
+      const LayerSnapshot &layerSnapshot = layers[rowNr];
+      if (layerSnapshot.effectNr >= effects.size()) continue; //layer without effect
+
+      //the normal (model) way if effect, projection or geometry changes, this creates the layer if needed
+      if (rowNr >= fix->layers.size() || fix->layers[rowNr]->effect != effects[layerSnapshot.effectNr])
+        mdl->setValue("layers", "effect", layerSnapshot.effectNr, rowNr);
+      LedsLayer *leds = fix->layers[rowNr];
+      if ((leds->projection?std::find(projections.begin(), projections.end(), leds->projection) - projections.begin():0) != layerSnapshot.projectionNr)
+        mdl->setValue("layers", "projection", layerSnapshot.projectionNr, rowNr);
+      mdl->setValue("layers", "start", layerSnapshot.start, rowNr); //only remaps if changed
+      mdl->setValue("layers", "middle", layerSnapshot.middle, rowNr);
+      mdl->setValue("layers", "end", layerSnapshot.end, rowNr);
+      mdl->setValue("effect", "palette", layerSnapshot.paletteNr, rowNr);
+
+      //same geometry: no remap, apply the data right away
+      if (!leds->doMap && doInitEffectRowNr != rowNr)
+        applySnapshotData(*leds, rowNr, layerSnapshot);
+      else
+        pendingDataRows |= 1UL << rowNr;
+    }
+  }
+
+  void LedModEffects::applySnapshotData(LedsLayer &leds, uint8_t rowNr, const LayerSnapshot &layerSnapshot) {
+    if (leds.effectData.setData(layerSnapshot.effectData.data(), layerSnapshot.effectData.size()))
+      syncControls(Variable("layers", "effect"), rowNr);
+    else { //size of the data depends on controls or layer size: the controls still have the same offset (state), the effect rebuilds the rest
+      uint8_t nrOfControls = applyControls(Variable("layers", "effect"), leds.effectData, layerSnapshot.effectData, rowNr);
+      ppf("applySnapshotData leds[%d] effectData size changed %d -> %d, %d controls applied\n", rowNr, layerSnapshot.effectData.size(), leds.effectData.bytesAllocated, nrOfControls);
+    }
+
+    //projection controls define the mapping, only remap if they differ
+    if (leds.projectionData.bytesAllocated != layerSnapshot.projectionData.size())
+      applyControls(Variable("layers", "projection"), leds.projectionData, layerSnapshot.projectionData, rowNr); //onChange of the controls remaps
+    else if (leds.projectionData.getData() && memcmp(leds.projectionData.getData(), layerSnapshot.projectionData.data(), layerSnapshot.projectionData.size()) != 0) {
+      leds.projectionData.setData(layerSnapshot.projectionData.data(), layerSnapshot.projectionData.size());
+      syncControls(Variable("layers", "projection"), rowNr);
+      leds.triggerMapping();
+    }
+  }
+
+  //copy sizeof(Type) bytes at offset (unaligned) if source contains them
+  template <typename Type>
+  static bool valueAt(const std::vector<byte> &source, size_t offset, Type &value) {
+    if (offset + sizeof(Type) > source.size()) return false;
+    memcpy(&value, source.data() + offset, sizeof(Type));
+    return true;
+  }
+
+  uint8_t LedModEffects::applyControls(Variable parentVar, const SharedData &sharedData, const std::vector<byte> &source, uint8_t rowNr) {
+    uint8_t nrOfControls = 0;
+    for (JsonObject childVar: parentVar.children()) {
+      Variable variable = Variable(childVar);
+      if (!childVar["p"].is<JsonArray>() || childVar["p"][rowNr].isNull()) continue; //only controls bound by pointer
+      const byte *pointer = (const byte *)childVar["p"][rowNr].as<int>();
+      const byte *data = sharedData.getData(); //per control: onChange of a previous control can reallocate
+      if (data == nullptr || pointer < data || pointer >= data + sharedData.bytesAllocated) continue; //not in this data
+      size_t offset = pointer - data;
+
+      //setValue: the pointer is set and onChange is called, as if changed in the UI
+      uint8_t value8; uint16_t value16; bool3State valueBool; Coord3D valueCoord;
+      if ((childVar["type"] == "select" || childVar["type"] == "range" || childVar["type"] == "pin") && valueAt(source, offset, value8))
+        variable.setValue(value8, rowNr);
+      else if (childVar["type"] == "number" && valueAt(source, offset, value16))
+        variable.setValue(value16, rowNr);
+      else if (childVar["type"] == "checkbox" && valueAt(source, offset, valueBool))
+        variable.setValue(valueBool, rowNr);
+      else if (childVar["type"] == "coord3D" && valueAt(source, offset, valueCoord))
+        variable.setValue(valueCoord, rowNr);
+      else
+        continue;
+      nrOfControls++;
+    }
+    return nrOfControls;
+  }
+
+  void LedModEffects::syncControls(Variable parentVar, uint8_t rowNr) {
+    for (JsonObject childVar: parentVar.children()) {
+      Variable variable = Variable(childVar);
+      if (!childVar["p"].is<JsonArray>() || childVar["p"][rowNr].isNull()) continue; //only controls bound by pointer
+      int pointer = childVar["p"][rowNr];
+      if (pointer == 0) continue;
+
+      if (childVar["type"] == "select" || childVar["type"] == "range" || childVar["type"] == "pin")
+        variable.setValue(*(uint8_t *)pointer, rowNr);
+      else if (childVar["type"] == "number")
+        variable.setValue(*(uint16_t *)pointer, rowNr);
+      else if (childVar["type"] == "checkbox")
+        variable.setValue(*(bool3State *)pointer, rowNr);
+      else if (childVar["type"] == "coord3D")
+        variable.setValue(*(Coord3D *)pointer, rowNr);
+    }
+  }
+
+  //layer: effectNr, projectionNr, paletteNr, start, middle, end, effectData size + bytes, projectionData size + bytes
+  static void writeLayerSnapshot(File &f, const LayerSnapshot &layerSnapshot) {
+    f.write(layerSnapshot.effectNr);
+    f.write(layerSnapshot.projectionNr);
+    f.write(layerSnapshot.paletteNr);
+    f.write((const uint8_t *)&layerSnapshot.start, sizeof(Coord3D));
+    f.write((const uint8_t *)&layerSnapshot.middle, sizeof(Coord3D));
+    f.write((const uint8_t *)&layerSnapshot.end, sizeof(Coord3D));
+    uint16_t size = layerSnapshot.effectData.size();
+    f.write((const uint8_t *)&size, sizeof(size));
+    f.write(layerSnapshot.effectData.data(), size);
+    size = layerSnapshot.projectionData.size();
+    f.write((const uint8_t *)&size, sizeof(size));
+    f.write(layerSnapshot.projectionData.data(), size);
+  }
+
+  static void readLayerSnapshot(File &f, LayerSnapshot &layerSnapshot) {
+    layerSnapshot.effectNr = f.read();
+    layerSnapshot.projectionNr = f.read();
+    layerSnapshot.paletteNr = f.read();
+    f.read((uint8_t *)&layerSnapshot.start, sizeof(Coord3D));
+    f.read((uint8_t *)&layerSnapshot.middle, sizeof(Coord3D));
+    f.read((uint8_t *)&layerSnapshot.end, sizeof(Coord3D));
+    uint16_t size = 0;
+    f.read((uint8_t *)&size, sizeof(size));
+    layerSnapshot.effectData.resize(size);
+    f.read(layerSnapshot.effectData.data(), size);
+    size = 0;
+    f.read((uint8_t *)&size, sizeof(size));
+    layerSnapshot.projectionData.resize(size);
+    f.read(layerSnapshot.projectionData.data(), size);
+  }
+
+  //format: 'S' 'L' 'S' 1, then per snapshot: nrOfLayers, per layer: see writeLayerSnapshot
+  void LedModEffects::readSnapshots() {
+    File f = files->open("/snapshots.bin", FILE_READ);
+    if (!f) return;
+
+    char header[4];
+    if (f.read((uint8_t *)header, sizeof(header)) != sizeof(header) || strncmp(header, "SLS\x01", 4) != 0) {
+      ppf("readSnapshots wrong format\n");
+      f.close();
+      return;
+    }
+
+    for (uint8_t snapshotNr = 0; snapshotNr < nrOfSnapshots && f.available(); snapshotNr++) {
+      snapshots[snapshotNr].clear();
+      uint8_t nrOfLayers = f.read();
+      for (uint8_t rowNr = 0; rowNr < nrOfLayers && f.available(); rowNr++) {
+        LayerSnapshot layerSnapshot;
+        readLayerSnapshot(f, layerSnapshot);
+        if (rowNr < maxSnapshotLayers && layerSnapshot.effectNr < effects.size() && layerSnapshot.projectionNr < projections.size())
+          snapshots[snapshotNr].push_back(layerSnapshot);
+      }
+    }
+    f.close();
+  }
+
+  void LedModEffects::writeSnapshots() {
+    //write to a temp file first so a reset during writing does not corrupt the snapshots (like writeObjectToFile)
+    File f = files->open("/snapshots.bin.tmp", FILE_WRITE);
+    if (!f) {
+      ppf("writeSnapshots open not successful\n");
+      return;
+    }
+    f.write((const uint8_t *)"SLS\x01", 4);
+    for (uint8_t snapshotNr = 0; snapshotNr < nrOfSnapshots; snapshotNr++) {
+      f.write((uint8_t)snapshots[snapshotNr].size());
+      for (const LayerSnapshot &layerSnapshot: snapshots[snapshotNr])
+        writeLayerSnapshot(f, layerSnapshot);
+    }
+    f.close();
+    if (!files->rename("/snapshots.bin.tmp", "/snapshots.bin"))
+      ppf("writeSnapshots rename not successful\n");
+  }
+
+  //audio data read by effects, recorded as raw bytes
+  #ifdef STARLIGHT_USERMOD_AUDIOSYNC
+    struct AudioField {
+      void *data;
+      uint8_t size;
+    };
+    static uint8_t audioFields(AudioField *fields) {
+      uint8_t nrOfFields = 0;
+      fields[nrOfFields++] = {audioSync->fftResults, sizeof(audioSync->fftResults)};
+      fields[nrOfFields++] = {&audioSync->volumeSmth, sizeof(audioSync->volumeSmth)};
+      fields[nrOfFields++] = {&audioSync->sync.volumeSmth, sizeof(audioSync->sync.volumeSmth)};
+      fields[nrOfFields++] = {&audioSync->sync.volumeRaw, sizeof(audioSync->sync.volumeRaw)};
+      fields[nrOfFields++] = {&audioSync->sync.FFT_MajorPeak, sizeof(audioSync->sync.FFT_MajorPeak)};
+      fields[nrOfFields++] = {&audioSync->sync.samplePeak, sizeof(audioSync->sync.samplePeak)};
+      fields[nrOfFields++] = {&audioSync->sync.soundPressure, sizeof(audioSync->sync.soundPressure)};
+      fields[nrOfFields++] = {&audioSync->sync.agcSensitivity, sizeof(audioSync->sync.agcSensitivity)};
+      return nrOfFields;
+    }
+  #endif
+
+  static void appendBytes(std::vector<byte> &buffer, const void *source, size_t size) {
+    buffer.insert(buffer.end(), (const byte *)source, (const byte *)source + size);
+  }
+
+  //FastLED time base (USE_GET_MILLISECOND_TIMER): beat8, beatsin16 etc. use the same time as effects, so a replay also replays them
+  uint32_t get_millisecond_timer() {
+    return sys?sys->now:millis(); //before the modules are created
+  }
+
+  void useRealRandomGenerator(bool useRandomHW); //Arduino core, WMath.cpp
+
+  //Arduino random() is also seeded while the recorder runs (seed 0 would keep the hardware random generator)
+  static void seedFrame(uint16_t seed) {
+    random16_set_seed(seed);
+    randomSeed(seed + 1);
+  }
+
+  //colors of unmapped pixels stored in the mapping table itself (vm_compact)
+  template <typename PhysMapType>
+  static void writeMapColors(File &f, const std::vector<PhysMapType> &mappingTable, uint16_t size) {
+    f.write((const uint8_t *)&size, sizeof(size));
+    f.write((const uint8_t *)mappingTable.data(), size * sizeof(PhysMapType));
+  }
+
+  template <typename PhysMapType>
+  static void readMapColors(File &f, std::vector<PhysMapType> &mappingTable) {
+    uint16_t size = 0;
+    f.read((uint8_t *)&size, sizeof(size));
+    for (uint16_t i = 0; i < size; i++) {
+      PhysMapType recorded;
+      f.read((uint8_t *)&recorded, sizeof(PhysMapType));
+      if (i < mappingTable.size() && mappingTable[i].mapType == m_color && recorded.mapType == m_color)
+        mappingTable[i].rgb = recorded.rgb;
+    }
+  }
+
+  //virtual pixels of a layer: unmapped colors (ledsV or mapping table), palette pixels and the layer pixels
+  static void writeLayerPixels(File &f, const LedsLayer &leds) {
+    uint16_t nrOfPixels = leds.ledsV?leds.nrOfLedsV:0;
+    f.write((const uint8_t *)&nrOfPixels, sizeof(nrOfPixels));
+    f.write((const uint8_t *)leds.ledsV, nrOfPixels * sizeof(CRGB));
+    f.write((uint8_t)leds.wideMapping);
+    if (leds.wideMapping)
+      writeMapColors(f, leds.mappingTableWide, leds.mappingTableSizeUsed);
+    else
+      writeMapColors(f, leds.mappingTable, leds.mappingTableSizeUsed);
+    nrOfPixels = leds.ledsPal?leds.nrOfLedsPal:0;
+    f.write((const uint8_t *)&nrOfPixels, sizeof(nrOfPixels));
+    f.write((const uint8_t *)leds.ledsPal, nrOfPixels * sizeof(LedsLayer::PalPixel));
+    nrOfPixels = leds.ledsL?leds.indexesP.size():0;
+    f.write((const uint8_t *)&nrOfPixels, sizeof(nrOfPixels));
+    f.write((const uint8_t *)leds.ledsL, nrOfPixels * sizeof(CRGB));
+  }
+
+  //only buffers with the same size as recorded are restored
+  static void readLayerPixels(File &f, LedsLayer &leds) {
+    uint16_t nrOfPixels = 0;
+    f.read((uint8_t *)&nrOfPixels, sizeof(nrOfPixels));
+    if (leds.ledsV && nrOfPixels == leds.nrOfLedsV)
+      f.read((uint8_t *)leds.ledsV, nrOfPixels * sizeof(CRGB));
+    else
+      f.seek(f.position() + nrOfPixels * sizeof(CRGB));
+    bool wideMapping = f.read();
+    if (wideMapping != leds.wideMapping) {
+      uint16_t size = 0;
+      f.read((uint8_t *)&size, sizeof(size));
+      f.seek(f.position() + size * (wideMapping?sizeof(PhysMapWide):sizeof(PhysMap)));
+    }
+    else if (wideMapping)
+      readMapColors(f, leds.mappingTableWide);
+    else
+      readMapColors(f, leds.mappingTable);
+    nrOfPixels = 0;
+    f.read((uint8_t *)&nrOfPixels, sizeof(nrOfPixels));
+    if (leds.ledsPal && nrOfPixels == leds.nrOfLedsPal)
+      f.read((uint8_t *)leds.ledsPal, nrOfPixels * sizeof(LedsLayer::PalPixel));
+    else
+      f.seek(f.position() + nrOfPixels * sizeof(LedsLayer::PalPixel));
+    nrOfPixels = 0;
+    f.read((uint8_t *)&nrOfPixels, sizeof(nrOfPixels));
+    if (nrOfPixels == 0)
+      leds.releaseLayerPixels();
+    else if (nrOfPixels == leds.indexesP.size() && (leds.ledsL || leds.restoreLayerPixels()))
+      f.read((uint8_t *)leds.ledsL, nrOfPixels * sizeof(CRGB));
+    else
+      f.seek(f.position() + nrOfPixels * sizeof(CRGB));
+  }
+
+  //bytes of a pointer bound control
+  static uint8_t controlSize(JsonObject childVar) {
+    if (childVar["type"] == "select" || childVar["type"] == "range" || childVar["type"] == "pin") return sizeof(uint8_t);
+    if (childVar["type"] == "number") return sizeof(uint16_t);
+    if (childVar["type"] == "checkbox") return sizeof(bool3State);
+    if (childVar["type"] == "coord3D") return sizeof(Coord3D);
+    return 0;
+  }
+
+  //format: 'S' 'L' 'R' 1, withFrames, nrOfLeds, nrOfLayers, per layer: see writeLayerSnapshot,
+  //  per layer: palette, see writeLayerPixels, then ledsP
+  //  per frame: now, seed, nrOfChanges + per change: rowNr, offset, size, bytes, audio size + bytes, ledsP if withFrames
+  void LedModEffects::startRecorder(uint8_t mode) {
+    closeRecorder();
+    if (mode == recorderOff) return;
+
+    if (fix->layers.empty() || fix->layers.size() > 32) { //pendingDataRows
+      stopRecorder("no layers");
+      return;
+    }
+    //transitions and crossfades are not recorded
+    for (LedsLayer *leds: fix->layers) leds->transition.end();
+    free(fadeBuffer);
+    fadeBuffer = nullptr;
+    recordFrames = 0;
+    replayDiffs = 0;
+
+    if (mode == recorderReplay) {
+      recordFile = files->open("/recording.bin", FILE_READ);
+      if (!recordFile) {
+        stopRecorder("no recording");
+        return;
+      }
+      char header[4];
+      if (recordFile.read((uint8_t *)header, sizeof(header)) != sizeof(header) || strncmp(header, "SLR\x01", 4) != 0) {
+        stopRecorder("wrong format");
+        return;
+      }
+      recordWithFrames = recordFile.read();
+      uint16_t nrOfLeds = 0;
+      recordFile.read((uint8_t *)&nrOfLeds, sizeof(nrOfLeds));
+      if (nrOfLeds != fix->nrOfLeds) {
+        stopRecorder("other fixture");
+        return;
+      }
+      uint8_t nrOfLayers = recordFile.read();
+      replayLayers.clear();
+      for (uint8_t rowNr = 0; rowNr < nrOfLayers; rowNr++) {
+        LayerSnapshot layerSnapshot;
+        readLayerSnapshot(recordFile, layerSnapshot);
+        if (layerSnapshot.effectNr >= effects.size() || layerSnapshot.projectionNr >= projections.size()) {
+          stopRecorder("unknown effect or projection");
+          return;
+        }
+        replayLayers.push_back(layerSnapshot);
+      }
+      //the pixels are read when the layers are ready, see replayFrameStart
+      recorderMode = mode;
+      replayStarted = false;
+      applyLayers(replayLayers);
+      ppf("replay %d layers\n", nrOfLayers);
+      return;
+    }
+
+    recordFile = files->open("/recording.bin", FILE_WRITE);
+    if (!recordFile) {
+      stopRecorder("open not successful");
+      return;
+    }
+    recordWithFrames = mode == recorderRecordFrames;
+    recordFile.write((const uint8_t *)"SLR\x01", 4);
+    recordFile.write((uint8_t)recordWithFrames);
+    recordFile.write((const uint8_t *)&fix->nrOfLeds, sizeof(fix->nrOfLeds));
+    recordFile.write((uint8_t)fix->layers.size());
+    for (uint8_t rowNr = 0; rowNr < fix->layers.size() && rowNr < maxSnapshotLayers; rowNr++) {
+      LayerSnapshot layerSnapshot;
+      captureLayer(rowNr, layerSnapshot);
+      writeLayerSnapshot(recordFile, layerSnapshot);
+    }
+    for (LedsLayer *leds: fix->layers) {
+      recordFile.write((const uint8_t *)&leds->palette, sizeof(CRGBPalette16));
+      writeLayerPixels(recordFile, *leds);
+    }
+    recordFile.write((const uint8_t *)fix->ledsP, fix->nrOfLeds * sizeof(CRGB));
+
+    //effect controls are bound to effectData, changes are recorded as bytes at an offset
+    recordedInputs.clear();
+    recordedLayout.clear();
+    for (uint8_t rowNr = 0; rowNr < fix->layers.size(); rowNr++) {
+      LedsLayer *leds = fix->layers[rowNr];
+      const byte *data = leds->effectData.getData();
+      recordedLayout.push_back({leds->effect, data});
+      for (JsonObject childVar: Variable("layers", "effect").children()) {
+        if (!childVar["p"].is<JsonArray>() || childVar["p"][rowNr].isNull()) continue; //only controls bound by pointer
+        int pointer = childVar["p"][rowNr];
+        const byte *value = (const byte *)pointer;
+        uint8_t size = controlSize(childVar);
+        if (!data || size == 0 || value < data || value + size > data + leds->effectData.bytesAllocated) continue; //not in effectData
+        recordedInputs.push_back({rowNr, (uint16_t)(value - data), size});
+      }
+      recordedInputs.push_back({rowNr, paletteOffset, sizeof(CRGBPalette16)});
+    }
+    recordedValues.clear();
+    for (const RecordedInput &input: recordedInputs) appendBytes(recordedValues, inputPointer(input), input.size);
+
+    recorderMode = mode;
+    ppf("record %d layers, %d inputs%s\n", fix->layers.size(), recordedInputs.size(), recordWithFrames?" with frames":"");
+  }
+
+  void LedModEffects::stopRecorder(const char *reason) {
+    ppf("recorder stopped: %s, %d frames, %d differ\n", reason, recordFrames, replayDiffs);
+    closeRecorder();
+    Variable(name, "recorder").setValue((uint8_t)recorderOff); //no restart as recorderMode is off already
+  }
+
+  void LedModEffects::closeRecorder() {
+    if (recordFile) {
+      recordFile.close();
+      if (recorderMode != recorderReplay) files->filesChanged = true;
+    }
+    if (pendingData == &replayLayers) pendingDataRows = 0;
+    if (recorderMode != recorderOff) useRealRandomGenerator(true); //undo seedFrame
+    recorderMode = recorderOff;
+    replayStarted = false;
+    recordedInputs.clear();
+    recordedValues.clear();
+    recordBuffer.clear();
+    recordBuffer.shrink_to_fit();
+    replayLayers.clear();
+    recordedLayout.clear();
+  }
+
+  const byte *LedModEffects::inputPointer(const RecordedInput &input) const {
+    const LedsLayer *leds = fix->layers[input.rowNr];
+    if (input.offset == paletteOffset) return (const byte *)&leds->palette;
+    return leds->effectData.getData() + input.offset;
+  }
+
+  bool LedModEffects::recordLayoutChanged() const {
+    if (fix->layers.size() != recordedLayout.size() || doInitEffectRowNr != UINT8_MAX) return true;
+    for (uint8_t rowNr = 0; rowNr < fix->layers.size(); rowNr++) {
+      const LedsLayer *leds = fix->layers[rowNr];
+      if (leds->doMap || leds->effect != recordedLayout[rowNr].first || leds->effectData.getData() != recordedLayout[rowNr].second) return true;
+    }
+    return false;
+  }
+
+  void LedModEffects::recordFrameStart() {
+    if (recordLayoutChanged()) {
+      stopRecorder("layers changed");
+      return;
+    }
+    uint32_t now = sys->now;
+    uint16_t seed = random16_get_seed();
+    seedFrame(seed);
+
+    recordBuffer.clear();
+    appendBytes(recordBuffer, &now, sizeof(now));
+    appendBytes(recordBuffer, &seed, sizeof(seed));
+
+    //changed controls since the previous frame
+    size_t nrOfChangesIndex = recordBuffer.size();
+    recordBuffer.push_back(0);
+    size_t valueIndex = 0;
+    for (const RecordedInput &input: recordedInputs) {
+      const byte *value = inputPointer(input);
+      if (memcmp(value, &recordedValues[valueIndex], input.size) != 0 && recordBuffer[nrOfChangesIndex] < UINT8_MAX) {
+        memcpy(&recordedValues[valueIndex], value, input.size);
+        appendBytes(recordBuffer, &input.rowNr, sizeof(input.rowNr));
+        appendBytes(recordBuffer, &input.offset, sizeof(input.offset));
+        appendBytes(recordBuffer, &input.size, sizeof(input.size));
+        appendBytes(recordBuffer, value, input.size);
+        recordBuffer[nrOfChangesIndex]++;
+      }
+      valueIndex += input.size;
+    }
+
+    size_t audioSizeIndex = recordBuffer.size();
+    recordBuffer.push_back(0);
+    #ifdef STARLIGHT_USERMOD_AUDIOSYNC
+      AudioField fields[8];
+      uint8_t nrOfFields = audioFields(fields);
+      for (uint8_t i = 0; i < nrOfFields; i++) {
+        appendBytes(recordBuffer, fields[i].data, fields[i].size);
+        recordBuffer[audioSizeIndex] += fields[i].size;
+      }
+    #endif
+  }
+
+  void LedModEffects::recordFrameEnd() {
+    if (recordWithFrames) appendBytes(recordBuffer, fix->ledsP, fix->nrOfLeds * sizeof(CRGB));
+    if (recordFile.write(recordBuffer.data(), recordBuffer.size()) != recordBuffer.size()) {
+      stopRecorder("write not successful");
+      return;
+    }
+    recordFrames++;
+    if (recordFile.position() > recordMaxKB * 1024) stopRecorder("full");
+  }
+
+  void LedModEffects::replayFrameStart() {
+    if (!replayStarted) {
+      //wait until the recorded layers are mapped and their data applied
+      if (pendingDataRows || doInitEffectRowNr != UINT8_MAX) return;
+      for (LedsLayer *leds: fix->layers) if (leds->doMap) return;
+      if (fix->layers.size() != replayLayers.size()) {
+        stopRecorder("other layers");
+        return;
+      }
+
+      //same start state as the recording: effectData, palette and pixels
+      recordedLayout.clear();
+      for (uint8_t rowNr = 0; rowNr < fix->layers.size(); rowNr++) {
+        LedsLayer *leds = fix->layers[rowNr];
+        if (!leds->effectData.setData(replayLayers[rowNr].effectData.data(), replayLayers[rowNr].effectData.size())) {
+          stopRecorder("effectData layout changed");
+          return;
+        }
+        syncControls(Variable("layers", "effect"), rowNr);
+        leds->transition.end();
+        recordFile.read((uint8_t *)&leds->palette, sizeof(CRGBPalette16));
+        readLayerPixels(recordFile, *leds);
+        recordedLayout.push_back({leds->effect, leds->effectData.getData()});
+      }
+      recordFile.read((uint8_t *)fix->ledsP, fix->nrOfLeds * sizeof(CRGB));
+      replayStarted = true;
+    }
+
+    if (recordLayoutChanged()) {
+      stopRecorder("layers changed");
+      return;
+    }
+    if (!recordFile.available()) {
+      stopRecorder("replay done");
+      return;
+    }
+
+    uint32_t now = 0;
+    uint16_t seed = 0;
+    recordFile.read((uint8_t *)&now, sizeof(now));
+    recordFile.read((uint8_t *)&seed, sizeof(seed));
+    realNow = sys->now;
+    sys->now = now; //restored in replayFrameEnd
+    seedFrame(seed);
+
+    uint8_t nrOfChanges = recordFile.read();
+    uint32_t changedRows = 0;
+    for (uint8_t i = 0; i < nrOfChanges; i++) {
+      RecordedInput input;
+      byte value[UINT8_MAX];
+      input.rowNr = recordFile.read();
+      recordFile.read((uint8_t *)&input.offset, sizeof(input.offset));
+      input.size = recordFile.read();
+      recordFile.read(value, input.size);
+      if (input.rowNr >= fix->layers.size()) continue;
+      LedsLayer *leds = fix->layers[input.rowNr];
+      if (input.offset == paletteOffset) {
+        if (input.size == sizeof(CRGBPalette16)) memcpy((void *)&leds->palette, value, input.size);
+      }
+      else if (leds->effectData.setData(value, input.offset, input.size))
+        changedRows |= 1 << input.rowNr;
+    }
+    for (uint8_t rowNr = 0; rowNr < fix->layers.size(); rowNr++)
+      if (changedRows & (1 << rowNr)) syncControls(Variable("layers", "effect"), rowNr);
+
+    uint8_t audioSize = recordFile.read();
+    #ifdef STARLIGHT_USERMOD_AUDIOSYNC
+      AudioField fields[8];
+      uint8_t nrOfFields = audioFields(fields);
+      uint8_t size = 0;
+      for (uint8_t i = 0; i < nrOfFields; i++) size += fields[i].size;
+      if (size == audioSize) {
+        for (uint8_t i = 0; i < nrOfFields; i++) recordFile.read((uint8_t *)fields[i].data, fields[i].size);
+        return;
+      }
+    #endif
+    recordFile.seek(recordFile.position() + audioSize); //other build
+  }
+
+  void LedModEffects::replayFrameEnd() {
+    sys->now = realNow;
+    if (recordWithFrames) {
+      //compare in chunks with the recorded frame
+      bool differs = false;
+      CRGB recorded[64];
+      for (uint16_t indexP = 0; indexP < fix->nrOfLeds; indexP += 64) {
+        uint16_t length = min(64, fix->nrOfLeds - indexP);
+        if (recordFile.read((uint8_t *)recorded, length * sizeof(CRGB)) != length * sizeof(CRGB)) break;
+        if (!differs && memcmp(recorded, fix->ledsP + indexP, length * sizeof(CRGB)) != 0) differs = true;
+      }
+      if (differs) {
+        if (replayDiffs == 0) ppf("replay frame %d differs from the recording\n", recordFrames);
+        replayDiffs++;
+      }
+    }
+    recordFrames++;
+  }
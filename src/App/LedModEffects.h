@@ -11,8 +11,21 @@
 #pragma once
 
 #include "LedLayer.h"
+#include "../Sys/SysModFiles.h"
 #include <vector>
 
+//binary state of one layer, a snapshot contains all layers (a precompiled preset)
+struct LayerSnapshot {
+  uint8_t effectNr;
+  uint8_t projectionNr;
+  uint8_t paletteNr;
+  Coord3D start;
+  Coord3D middle;
+  Coord3D end;
+  std::vector<byte> effectData; //effect controls and effect state
+  std::vector<byte> projectionData;
+};
+
 class LedModEffects:public SysModule {
 
 public:
@@ -24,6 +37,14 @@ public:
 
   uint8_t doInitEffectRowNr = UINT8_MAX;
 
+  static const uint8_t nrOfSnapshots = 8;
+  static const uint8_t maxSnapshotLayers = 32; //bits in pendingDataRows
+  std::vector<LayerSnapshot> snapshots[nrOfSnapshots];
+  uint16_t crossfadeMillis = 0; //when switching snapshots
+
+  uint16_t transitionMillis = 0; //when switching effects
+  uint16_t transitionMaxKB = 32; //memory cap of all transitions together
+
   LedModEffects();
 
   void setup() override;
@@ -35,10 +56,84 @@ public:
 
   // void loop10s() override;
 
+  //store the state of all layers in snapshot snapshotNr
+  void captureSnapshot(uint8_t snapshotNr);
+
+  //snapshotNr will be applied at the start of the next frame
+  void selectSnapshot(uint8_t snapshotNr) {pendingSnapshot = snapshotNr;}
+
+  //snapshots are stored in /snapshots.bin
+  void readSnapshots();
+  void writeSnapshots();
+
+  //recorder: the inputs of each frame (time, random seed, audio, control changes) in /recording.bin, optionally the frames itself
+  //  a replay starts from the recorded state of the layers and renders the same frames, recorded frames are compared
+  enum RecorderMode {recorderOff, recorderRecord, recorderRecordFrames, recorderReplay};
+  uint8_t recorderMode = recorderOff;
+  uint16_t recordMaxKB = 256; //LittleFS space of a recording
+  unsigned long recordFrames = 0;
+  unsigned long replayDiffs = 0; //replayed frames which differ from the recorded frame
+
+  //mode will be started at the start of the next frame
+  void selectRecorder(uint8_t mode) {pendingRecorder = mode;}
+
 private:
   unsigned long frameMillis = 0;
   JsonObject varSystem = JsonObject(); //for use in loop
 
+  uint8_t pendingSnapshot = UINT8_MAX;
+  const std::vector<LayerSnapshot> *pendingData = nullptr; //layers of which the data is applied after remapping
+  uint32_t pendingDataRows = 0; //bit per layer, max maxSnapshotLayers
+
+  CRGB *fadeBuffer = nullptr; //last frame before a snapshot switch, layers are composited during the fade so effects do not read back the blended ledsP
+  uint16_t fadeLength = 0;
+  unsigned long fadeStart = 0;
+
+  //keep the current effect of leds running until transitionMillis after the new effect is set
+  void startTransition(LedsLayer &leds);
+  //render outgoing and incoming effect in their own buffer and blend them into ledsP
+  void loopTransition(LedsLayer &leds);
+  size_t transitionBytes() const;
+
+  void captureLayer(uint8_t rowNr, LayerSnapshot &layerSnapshot);
+  void applySnapshot(uint8_t snapshotNr);
+  void applyLayers(const std::vector<LayerSnapshot> &layers);
+  void applySnapshotData(LedsLayer &leds, uint8_t rowNr, const LayerSnapshot &layerSnapshot);
+  //set the values of pointer bound controls of parentVar in the model (after the pointers have been changed)
+  void syncControls(Variable parentVar, uint8_t rowNr);
+  //set pointer bound controls of parentVar to the bytes at the same offset in source (if the layout of the data changed)
+  uint8_t applyControls(Variable parentVar, const SharedData &sharedData, const std::vector<byte> &source, uint8_t rowNr);
+
+  //control (or palette) of a layer which is checked for changes each recorded frame
+  struct RecordedInput {
+    uint8_t rowNr;
+    uint16_t offset; //in effectData, paletteOffset for the palette
+    uint8_t size;
+  };
+  static const uint16_t paletteOffset = UINT16_MAX;
+
+  uint8_t pendingRecorder = UINT8_MAX;
+  File recordFile;
+  bool replayStarted = false;
+  unsigned long realNow = 0; //sys->now is replaced by the recorded time during a replayed frame
+  std::vector<RecordedInput> recordedInputs;
+  std::vector<byte> recordedValues; //last values of recordedInputs
+  std::vector<byte> recordBuffer; //one frame, written at once
+  std::vector<LayerSnapshot> replayLayers; //start state of the replay
+  std::vector<std::pair<Effect *, const byte *>> recordedLayout; //recording stops if effect or effectData of a layer changes
+
+  bool recordWithFrames = false;
+
+  void startRecorder(uint8_t mode);
+  void stopRecorder(const char *reason);
+  void closeRecorder();
+  const byte *inputPointer(const RecordedInput &input) const;
+  bool recordLayoutChanged() const;
+  //before the effects run: record or replay the inputs, after: record or compare the frame
+  void recordFrameStart();
+  void recordFrameEnd();
+  void replayFrameStart();
+  void replayFrameEnd();
 };
 
 extern LedModEffects *eff;
\ No newline at end of file
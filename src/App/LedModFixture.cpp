@@ -271,13 +271,13 @@
       default: return false; 
     }}); //fixture
 
-    ui->initCoord3D(currentVar, "size", &fixSize, 0, STARLIGHT_MAXLEDS, true, [](EventArguments) { switch (eventType) {
+    ui->initCoord3D(currentVar, "size", &fixSize, 0, UINT16_MAX, true, [](EventArguments) { switch (eventType) {
       default: return false;
     }});
 
-    ui->initNumber(currentVar, "count", &nrOfLeds, 0, UINT16_MAX, true, [](EventArguments) { switch (eventType) {
+    ui->initNumber(currentVar, "count", &nrOfLeds, 0, UINT16_MAX, true, [this](EventArguments) { switch (eventType) {
       case onUI:
-        web->addResponse(variable.var, "comment", "Max %d", STARLIGHT_MAXLEDS, 0); //0 is to force format overload used
+        web->addResponse(variable.var, "comment", "%d B", nrOfLedsAllocated * sizeof(CRGB), 0); //0 is to force format overload used
         return true;
       default: return false;
     }});
@@ -385,15 +385,8 @@
 
     mappingStatus = 2; //mapping in progress
 
-    //init pixels, with some debugging for panels
-    // for (int i = 0; i < STARLIGHT_MAXLEDS / 256; i++) //panels
-    // {
-    //   //pixels in panels
-    //   for (int j=0;j<256;j++)
-    //     ledsP[j+i*256]=j < i + 1?CRGB::Red: CRGB::Black; //each panel get as much red pixels as its sequence in the chain
-    // }
-    for (int i = 0; i < STARLIGHT_MAXLEDS; i++)
-      ledsP[i] = CRGB::Black;
+    //init pixels
+    memset((void *)ledsP, 0, nrOfLedsAllocated * sizeof(CRGB));
 
     char fileName[32] = "";
 
@@ -511,6 +504,23 @@
 
   } //mapInitAlloc
 
+  bool LedModFixture::allocLeds(uint16_t nrOfLeds) {
+    if (nrOfLeds == 0) nrOfLeds = 1; //always a valid ledsP
+    //ledsP is cleared after allocation so no need to keep the content
+    CRGB *newLedsP = (CRGB *)(psramFound()?ps_malloc(nrOfLeds * sizeof(CRGB)):malloc(nrOfLeds * sizeof(CRGB)));
+    if (!newLedsP) {
+      ppf("allocLeds failed %d B, keep %d leds\n", nrOfLeds * sizeof(CRGB), nrOfLedsAllocated);
+      return false;
+    }
+    driverMove(newLedsP, nrOfLeds); //no driver may point at the old ledsP
+    free(ledsP);
+    ledsP = newLedsP;
+    nrOfLedsAllocated = nrOfLeds;
+    memset((void *)ledsP, 0, nrOfLedsAllocated * sizeof(CRGB));
+    ppf("allocLeds %d leds %d B %s\n", nrOfLedsAllocated, nrOfLedsAllocated * sizeof(CRGB), psramFound()?"PSRAM":"RAM");
+    return true;
+  }
+
 #define headerBytesFixture 16 // so 680 pixels will fit in a PACKAGE_SIZE package ?
 
 void LedModFixture::addPixelsPre() {
@@ -519,7 +529,7 @@ void LedModFixture::addPixelsPre() {
   if (pass == 1) {
     fixSize = {0, 0, 0}; //start counting
     nrOfLeds = 0; //start counting
-  } else if (nrOfLeds <= STARLIGHT_MAXLEDS) {
+  } else if (nrOfLeds <= nrOfLedsAllocated) {
 
     // reset leds
     uint8_t rowNr = 0;
@@ -574,9 +584,9 @@ void LedModFixture::addPixel(Coord3D pixel) {
     // ppf(".");
     fixSize = fixSize.maximum(pixel);
     nrOfLeds++;
-  } else if (nrOfLeds <= STARLIGHT_MAXLEDS) {
+  } else if (nrOfLeds <= nrOfLedsAllocated) {
 
-    if (indexP < STARLIGHT_MAXLEDS) {
+    if (indexP < nrOfLeds) {
 
       if (bytesPerPixel && doSendFixtureDefinition) {
         //send pixel to ui ...
@@ -620,7 +630,7 @@ void LedModFixture::addPixel(Coord3D pixel) {
       } //for layers
     } //indexP < max
     else 
-      ppf("dev post indexP too high %d>=%d or %d p:%d,%d,%d\n", indexP, nrOfLeds, STARLIGHT_MAXLEDS, pixel.x, pixel.y, pixel.z);
+      ppf("dev post indexP too high %d>=%d p:%d,%d,%d\n", indexP, nrOfLeds, pixel.x, pixel.y, pixel.z);
 
     indexP++; //also increase if no buffer created
   }
@@ -629,7 +639,7 @@ void LedModFixture::addPixel(Coord3D pixel) {
 void LedModFixture::addPin(uint8_t pin) {
   // ppf("addPin{%d} %d\n", pass, pin);
   if (pass == 1) {
-  } else if (nrOfLeds <= STARLIGHT_MAXLEDS) {
+  } else if (nrOfLeds <= nrOfLedsAllocated) {
     if (doAllocPins) {
       ppf("addPin %d (%d %d)\n", pin, indexP, nrOfLeds);
       //check if pin already allocated, if so, extend range in details
@@ -670,7 +680,16 @@ void LedModFixture::addPixelsPost() {
   if (pass == 1) {
     fixSize = fixSize / factor + Coord3D{1,1,1};
     ppf("addPixelsPost(%d) size s:%d,%d,%d #:%d %d ms\n", pass, fixSize.x, fixSize.y, fixSize.z, nrOfLeds);
-  } else if (nrOfLeds <= STARLIGHT_MAXLEDS) {
+
+    if (nrOfLeds != nrOfLedsAllocated) {
+      CRGB *oldLedsP = ledsP;
+      if (!allocLeds(nrOfLeds)) {
+        ppf("addPixelsPost(%d) fixture truncated to %d leds\n", pass, nrOfLedsAllocated);
+        nrOfLeds = nrOfLedsAllocated;
+      }
+      if (ledsP != oldLedsP) doAllocPins = true; //drivers init again with the new ledsP (FastLED controllers are reused)
+    }
+  } else if (nrOfLeds <= nrOfLedsAllocated) {
 
     if (bytesPerPixel && doSendFixtureDefinition) {
       if (wsBuf) {
@@ -705,13 +724,7 @@ void LedModFixture::addPixelsPost() {
     mdl->setValue("fixture", "size", fixSize);
     mdl->setValue("fixture", "count", nrOfLeds);
 
-    //init pixelsToBlend
-    for (uint16_t i=0; i<nrOfLeds; i++) {
-      if (pixelsToBlend.size() < nrOfLeds)
-        pixelsToBlend.push_back(false);
-    }
-
-    ppf("addPixelsPost(%d) fixture.size = so:%d + l:(%d * %d) B %d ms\n", pass, sizeof(this), STARLIGHT_MAXLEDS, sizeof(CRGB), millis() - start); //56
+    ppf("addPixelsPost(%d) fixture.size = so:%d + l:(%d * %d) B %d ms\n", pass, sizeof(this), nrOfLedsAllocated, sizeof(CRGB), millis() - start); //56
   }
 
   if (pass == 2) {
@@ -817,6 +830,9 @@ void LedModFixture::addPixelsPost() {
       // driver.setBrightness(setMaxPowerBrightnessFactor / 256); //not brighter then the set limit (WIP)
     }
   }
+  void LedModFixture::driverMove(CRGB *newLedsP, uint16_t nrOfLeds) {
+    //initled is done again with the new ledsP (doAllocPins) in the same mapping, before the next show
+  }
   void LedModFixture::driverShow() {
     // if statement needed as we need to wait until the driver is initialised
     #if CONFIG_IDF_TARGET_ESP32S3 || CONFIG_IDF_TARGET_ESP32S2
@@ -854,7 +870,7 @@ void LedModFixture::addPixelsPost() {
     }
     ppf("]\n");
 
-    for (int i=0; i< STARLIGHT_MAXLEDS; i++) ledsP[i] = CRGB::Black; //avoid very bright pixels during reboot (WIP)
+    memset((void *)ledsP, 0, nrOfLedsAllocated * sizeof(CRGB)); //avoid very bright pixels during reboot (WIP)
     
     #if CONFIG_IDF_TARGET_ESP32S3
       driver.initled(ledsP, pins, STARLIGHT_ICVLD_CLOCK_PIN, STARLIGHT_ICVLD_LATCH_PIN, clock_1000KHZ);
@@ -873,6 +889,9 @@ void LedModFixture::addPixelsPost() {
     Variable("Fixture", "brightness").triggerEvent(onChange, UINT8_MAX, true); //set brightness (init is true so bri value not send via udp)
 
   }
+  void LedModFixture::driverMove(CRGB *newLedsP, uint16_t nrOfLeds) {
+    //initled is done again with the new ledsP (doAllocPins) in the same mapping, before the next show
+  }
   void LedModFixture::driverShow() {
     // if statement needed as we need to wait until the driver is initialised
     if (driver.driverInit)
@@ -884,6 +903,8 @@ void LedModFixture::addPixelsPost() {
       ppf("sortpins s:%d #:%d p:%d\n", sortedPin.startLed, sortedPin.nrOfLeds, sortedPin.pin);
     }
   }
+  void LedModFixture::driverMove(CRGB *newLedsP, uint16_t nrOfLeds) {
+  }
   void LedModFixture::driverShow() {
     if (driver.driverInit)
       driver.showPixels(WAIT);
@@ -891,7 +912,11 @@ void LedModFixture::addPixelsPost() {
 #else //FastLED driver
 
   //commented pins: error: static assertion failed: Invalid pin specified
+  //  FastLED controllers can not be removed: existing controllers (in addLeds order) get the new leds, only new pins are added
   void LedModFixture::driverInit(const std::vector<SortedPin> &sortedPins) {
+    if (FastLED.count() && FastLED.count() != sortedPins.size())
+      ppf("driverInit %d controllers for %d pins, reboot to change pins\n", FastLED.count(), sortedPins.size());
+    uint8_t controllerNr = 0;
     for (const SortedPin &sortedPin : sortedPins) {
       ppf("sortpins s:%d #:%d p:%d\n", sortedPin.startLed, sortedPin.nrOfLeds, sortedPin.pin);
 
@@ -899,6 +924,12 @@ void LedModFixture::addPixelsPost() {
       uint16_t nrOfLeds = sortedPin.nrOfLeds;
       uint16_t pin = sortedPin.pin;
 
+      if (controllerNr < FastLED.count()) {
+        FastLED[controllerNr++].setLeds(ledsP + startLed, nrOfLeds);
+        continue;
+      }
+      controllerNr++;
+
       switch (sortedPin.pin) {
       #if CONFIG_IDF_TARGET_ESP32
         case 0: FastLED.addLeds<STARLIGHT_CHIPSET, 0>(ledsP, startLed, nrOfLeds).setCorrection(TypicalLEDStrip); break;
@@ -1100,6 +1131,13 @@ void LedModFixture::addPixelsPost() {
     } //sortedPins
   }
 
+  void LedModFixture::driverMove(CRGB *newLedsP, uint16_t nrOfLeds) {
+    for (int controllerNr = 0; controllerNr < FastLED.count(); controllerNr++) {
+      CLEDController &controller = FastLED[controllerNr];
+      int offset = min((int)(controller.leds() - ledsP), (int)nrOfLeds); //same leds, within the new ledsP
+      controller.setLeds(newLedsP + offset, min(controller.size(), nrOfLeds - offset));
+    }
+  }
   void LedModFixture::driverShow() {
     FastLED.show();
   }
@@ -77,26 +77,12 @@ class LedModFixture: public SysModule {
 
 public:
 
-  CRGB ledsP[STARLIGHT_MAXLEDS];
-
-  // CRGB *leds = nullptr;
-    // if (!leds)
-  //   leds = (CRGB*)calloc(nrOfLeds, sizeof(CRGB));
-  // else
-  //   leds = (CRGB*)reallocarray(leds, nrOfLeds, sizeof(CRGB));
-  // if (leds) free(leds);
-  // leds = (CRGB*)malloc(nrOfLeds * sizeof(CRGB));
-  // leds = (CRGB*)reallocarray
-
-  std::vector<bool> pixelsToBlend; //this is a 1-bit vector !!! overlapping effects will blend
-  LedModFixture() :SysModule("Fixture") {
-    //init pixelsToBlend
-    for (uint16_t i=0; i<nrOfLeds; i++) {
-      if (pixelsToBlend.size() < nrOfLeds)
-        pixelsToBlend.push_back(false);
-    }
-    ppf("Fixture constructor ptb:%d", pixelsToBlend.size());
+  CRGB *ledsP = nullptr; //nrOfLeds, (re)allocated after the first mapping pass
+  uint16_t nrOfLedsAllocated = 0;
 
+  LedModFixture() :SysModule("Fixture") {
+    ledsP = (CRGB *)calloc(nrOfLeds, sizeof(CRGB)); //default fixture until mapped
+    if (ledsP) nrOfLedsAllocated = nrOfLeds;
     #ifdef STARLIGHT_CLOCKLESS_LED_DRIVER
       //'hack' to make sure show is not called before init
       #if !(CONFIG_IDF_TARGET_ESP32S3 || CONFIG_IDF_TARGET_ESP32S2)
@@ -135,8 +121,6 @@ public:
   bool doAllocPins = false;
   bool doSendFixtureDefinition = false;
 
-  uint8_t globalBlend = 128;
-
   uint16_t fps = 200;
   uint16_t realFps = 200;
   bool3State showTicker = false;
@@ -149,6 +133,8 @@ public:
   uint8_t currPin;
 
   void mapInitAlloc();
+  //allocate ledsP for nrOfLeds (PSRAM if available), false if not possible
+  bool allocLeds(uint16_t nrOfLeds);
 
   //load fixture json file, parse it and depending on the projection, create a mapping for it
   uint16_t previewBufferIndex = 0;
@@ -160,6 +146,8 @@ public:
   void addPin(uint8_t pin);
   void addPixelsPost();
   void driverInit(const std::vector<SortedPin> &sortedPins);
+  //point the drivers at the new ledsP, before the old one is freed
+  void driverMove(CRGB *newLedsP, uint16_t nrOfLeds);
   void driverShow();
 
   #ifdef STARBASE_USERMOD_LIVE
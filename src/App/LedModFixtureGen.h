@@ -623,13 +623,13 @@ public:
           width = 10; height = 54;
         }
 
-        ui->initNumber(fixtureVariable, "width", width, 1, STARLIGHT_MAXLEDS, false, [this,fgText](EventArguments) { switch (eventType) {
+        ui->initNumber(fixtureVariable, "width", width, 1, UINT16_MAX, false, [this,fgText](EventArguments) { switch (eventType) {
           case onChange:
             rebuildMatrix(fgText);
             return true;
           default: return false; 
         }});
-        ui->initNumber(fixtureVariable, "height", height, 1, STARLIGHT_MAXLEDS, false, [this,fgText](EventArguments) { switch (eventType) {
+        ui->initNumber(fixtureVariable, "height", height, 1, UINT16_MAX, false, [this,fgText](EventArguments) { switch (eventType) {
           case onChange:
             rebuildMatrix(fgText);
             return true;
@@ -644,7 +644,7 @@ public:
         else if (strnstr(fgText, "CubeBox", 32) != nullptr)
           length = 8;
 
-        ui->initNumber(fixtureVariable, "length", length, 1, STARLIGHT_MAXLEDS, false, [this,fgText](EventArguments) { switch (eventType) {
+        ui->initNumber(fixtureVariable, "length", length, 1, UINT16_MAX, false, [this,fgText](EventArguments) { switch (eventType) {
           case onChange:
             rebuildCube(fgText);
             return true;
@@ -688,7 +688,7 @@ public:
         default: return false;
       }});
 
-      ui->initCoord3D(parentVariable, "firstLed", {0,0,0}, 0, STARLIGHT_MAXLEDS, false, [fgGroup](EventArguments) { switch (eventType) {
+      ui->initCoord3D(parentVariable, "firstLed", {0,0,0}, 0, UINT16_MAX, false, [fgGroup](EventArguments) { switch (eventType) {
         case onUI:
           //show Top Left for all fixture except Matrix as it has its own
           if (strncmp(fgGroup, "Matrices", 9) != 0 && strncmp(fgGroup, "Cubes", 6) != 0)
@@ -702,11 +702,11 @@ public:
     //custom variables
     if (strncmp(fgGroup, "Strips", 7) == 0) {
       if (strnstr(fgText, "Spiral", 32) != nullptr) {
-        ui->initNumber(parentVariable, "#Leds", 64, 1, STARLIGHT_MAXLEDS);
+        ui->initNumber(parentVariable, "#Leds", 64, 1, UINT16_MAX);
         ui->initNumber(parentVariable, "radius", 100, 1, 1000);
       }
       else if (strnstr(fgText, "Helix", 32) != nullptr) {
-        ui->initNumber(parentVariable, "#Leds", 100, 1, STARLIGHT_MAXLEDS);
+        ui->initNumber(parentVariable, "#Leds", 100, 1, UINT16_MAX);
         ui->initNumber(parentVariable, "radius", 60, 1, 600);
         ui->initNumber(parentVariable, "pitch", 30, 1, 100);
         ui->initNumber(parentVariable, "deltaLed", 30, 1, 100);
@@ -714,14 +714,14 @@ public:
     }
     else if (strncmp(fgGroup, "Matrices", 9) == 0 || strncmp(fgGroup, "Cubes", 6) == 0) {
 
-      ui->initCoord3D(parentVariable, "rowEnd", {7,0,0}, 0, STARLIGHT_MAXLEDS, false, [](EventArguments) { switch (eventType) {
+      ui->initCoord3D(parentVariable, "rowEnd", {7,0,0}, 0, UINT16_MAX, false, [](EventArguments) { switch (eventType) {
         case onUI:
           variable.setComment("-> Orientation");
           return true;
         default: return false;
       }});
 
-      ui->initCoord3D(parentVariable, "columnEnd", {7,7,0}, 0, STARLIGHT_MAXLEDS, false, [](EventArguments) { switch (eventType) {
+      ui->initCoord3D(parentVariable, "columnEnd", {7,7,0}, 0, UINT16_MAX, false, [](EventArguments) { switch (eventType) {
         case onUI:
           variable.setComment("Last LED -> nrOfLeds, Serpentine");
           return true;
@@ -729,7 +729,7 @@ public:
       }});
     }
     else if (strncmp(fgGroup, "Rings", 6) == 0) {
-      ui->initNumber(parentVariable, "#Leds", 24, 1, STARLIGHT_MAXLEDS);
+      ui->initNumber(parentVariable, "#Leds", 24, 1, UINT16_MAX);
     }
     else if (strncmp(fgGroup, "Shapes", 7) == 0) {
       if (strnstr(fgText, "Rings241", 32) != nullptr) {
@@ -0,0 +1,136 @@
+/*
+   @title     StarLight
+   @file      LedNoise.h
+   @date      20241105
+   @repo      https://github.com/MoonModules/StarLight
+   @Authors   https://github.com/MoonModules/StarLight/commits/main
+   @Copyright © 2024 Github StarLight Commit Authors
+   @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+   @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+*/
+#pragma once
+
+#include "LedLayer.h"
+
+//batch 3D Perlin noise, 8 bit, same scheme as FastLED inoise8 (classic permutation, eased fades and 8 bit gradients)
+//  evaluated per row: lattice hashing and the y and z fades are done once per lattice cell / row instead of for each pixel
+
+//Ken Perlin's permutation, first entry repeated so index 256 can be used
+static const uint8_t noisePerm[257] = {
+  151,160,137,91,90,15,131,13,201,95,96,53,194,233,7,225,
+  140,36,103,30,69,142,8,99,37,240,21,10,23,190,6,148,
+  247,120,234,75,0,26,197,62,94,252,219,203,117,35,11,32,
+  57,177,33,88,237,149,56,87,174,20,125,136,171,168,68,175,
+  74,165,71,134,139,48,27,166,77,146,158,231,83,111,229,122,
+  60,211,133,230,220,105,92,41,55,46,245,40,244,102,143,54,
+  65,25,63,161,1,216,80,73,209,76,132,187,208,89,18,169,
+  200,196,135,130,116,188,159,86,164,100,109,198,173,186,3,64,
+  52,217,226,250,124,123,5,202,38,147,118,126,255,82,85,212,
+  207,206,59,227,47,16,58,17,182,189,28,42,223,183,170,213,
+  119,248,152,2,44,154,163,70,221,153,101,155,167,43,172,9,
+  129,22,39,253,19,98,108,110,79,113,224,232,178,185,112,104,
+  218,246,97,228,251,34,242,193,238,210,144,12,191,179,162,241,
+  81,51,145,235,249,14,239,107,49,192,214,31,181,199,106,157,
+  184,84,204,176,115,121,50,45,127,4,150,254,138,236,205,93,
+  222,114,67,29,24,72,243,141,128,195,78,66,215,61,156,180,
+  151
+};
+
+static inline int8_t noiseGrad8(uint8_t hash, int8_t x, int8_t y, int8_t z) {
+  hash &= 0xF;
+  int8_t u = (hash & 8)?y:x;
+  int8_t v = hash < 4?y:(hash == 12 || hash == 14)?x:z;
+  if (hash & 1) u = -u;
+  if (hash & 2) v = -v;
+  return avg7(u, v);
+}
+
+//count noise values of x, x + xStep, ... at y, z
+static void inoise8Row(uint8_t *dest, uint16_t count, uint16_t x, uint16_t xStep, uint16_t y, uint16_t z) {
+  const uint8_t Y = y >> 8, Z = z >> 8;
+  const uint8_t v = ease8InOutQuad(y), w = ease8InOutQuad(z);
+  const int8_t yy = (uint8_t)y >> 1, zz = (uint8_t)z >> 1;
+  const int8_t N = 0x80;
+
+  uint16_t X = UINT16_MAX; //lattice cell of the hashes
+  uint8_t h[8];
+  for (uint16_t i = 0; i < count; i++, x += xStep) {
+    if ((x >> 8) != X) { //hash cube corners once per cell
+      X = x >> 8;
+      uint8_t A = noisePerm[(uint8_t)X] + Y, B = noisePerm[(uint8_t)(X + 1)] + Y;
+      uint8_t AA = noisePerm[A] + Z, AB = noisePerm[A + 1] + Z, BA = noisePerm[B] + Z, BB = noisePerm[B + 1] + Z;
+      h[0] = noisePerm[AA]; h[1] = noisePerm[BA]; h[2] = noisePerm[AB]; h[3] = noisePerm[BB];
+      h[4] = noisePerm[AA + 1]; h[5] = noisePerm[BA + 1]; h[6] = noisePerm[AB + 1]; h[7] = noisePerm[BB + 1];
+    }
+    const uint8_t u = ease8InOutQuad(x);
+    const int8_t xx = (uint8_t)x >> 1;
+
+    int8_t X1 = lerp7by8(noiseGrad8(h[0], xx, yy, zz), noiseGrad8(h[1], xx - N, yy, zz), u);
+    int8_t X2 = lerp7by8(noiseGrad8(h[2], xx, yy - N, zz), noiseGrad8(h[3], xx - N, yy - N, zz), u);
+    int8_t X3 = lerp7by8(noiseGrad8(h[4], xx, yy, zz - N), noiseGrad8(h[5], xx - N, yy, zz - N), u);
+    int8_t X4 = lerp7by8(noiseGrad8(h[6], xx, yy - N, zz - N), noiseGrad8(h[7], xx - N, yy - N, zz - N), u);
+
+    int8_t n = lerp7by8(lerp7by8(X1, X2, v), lerp7by8(X3, X4, v), w); //-64..64
+    dest[i] = qadd8(n + 64, n + 64);
+  }
+}
+
+//plane of size.x * size.y noise values (x order) at z
+static void inoise8Plane(uint8_t *dest, const Coord3D &size, uint16_t x, uint16_t xStep, uint16_t y, uint16_t yStep, uint16_t z) {
+  for (int row = 0; row < size.y; row++, y += yStep)
+    inoise8Row(dest + row * size.x, size.x, x, xStep, y, z);
+}
+
+//temporal cache for slowly moving fields: planes at keyframes every 1 << shift z units, frames in between are interpolated
+//  costs one plane per keyframe instead of one per frame, planes are stored in effectData
+struct NoiseCache {
+  struct Key {
+    bool3State valid;
+    bool3State first; //which plane is the first
+    uint16_t x, xStep, y, yStep; //a change of these or the size invalidates the planes
+    uint16_t sizeX, sizeY;
+    uint32_t z; //z of the first plane
+  };
+  Key *key = nullptr;
+  uint8_t *keys = nullptr; //2 planes
+  Coord3D size;
+  uint8_t *plane0, *plane1, frac; //set by update
+
+  bool bind(LedsLayer &leds) {
+    size = Coord3D{leds.size.x, leds.size.y, 1};
+    key = leds.effectData.readWrite<Key>();
+    keys = leds.effectData.readWrite<uint8_t>(2 * size.x * size.y);
+    return leds.effectData.success();
+  }
+
+  //keyframes around z, z is not wrapped so the cache does not jump at 65536
+  void update(uint16_t x, uint16_t xStep, uint16_t y, uint16_t yStep, uint32_t z, uint8_t shift) {
+    const uint32_t interval = 1 << shift;
+    const uint32_t z0 = z & ~(interval - 1);
+    const int planeSize = size.x * size.y;
+    if (!key->valid || key->x != x || key->xStep != xStep || key->y != y || key->yStep != yStep || key->sizeX != size.x || key->sizeY != size.y) {
+      key->valid = false;
+      key->x = x; key->xStep = xStep; key->y = y; key->yStep = yStep;
+      key->sizeX = size.x; key->sizeY = size.y;
+    }
+    plane0 = keys + (key->first?planeSize:0); plane1 = keys + (key->first?0:planeSize);
+    if (!key->valid || key->z != z0) {
+      if (key->valid && key->z + interval == z0) { //moved one keyframe: second plane becomes first
+        key->first = !key->first;
+        uint8_t *swap = plane0; plane0 = plane1; plane1 = swap;
+      }
+      else
+        inoise8Plane(plane0, size, x, xStep, y, yStep, z0);
+      inoise8Plane(plane1, size, x, xStep, y, yStep, z0 + interval);
+      key->z = z0;
+      key->valid = true;
+    }
+    frac = (z - z0) << (8 - shift);
+  }
+
+  //interpolated row y of the plane at z of update
+  void row(uint8_t *dest, int y) const {
+    const int offset = y * size.x;
+    for (int i = 0; i < size.x; i++) dest[i] = lerp8by8(plane0[offset + i], plane1[offset + i], frac);
+  }
+};
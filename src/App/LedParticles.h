@@ -0,0 +1,188 @@
+/*
+   @title     StarLight
+   @file      LedParticles.h
+   @date      20241105
+   @repo      https://github.com/MoonModules/StarLight
+   @Authors   https://github.com/MoonModules/StarLight/commits/main
+   @Copyright © 2024 Github StarLight Commit Authors
+   @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+   @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+*/
+#pragma once
+
+#include "LedLayer.h"
+
+//particle engine shared by particle effects
+//  structure of arrays in effectData, positions and velocities in 16.16 fixed point
+//  batched passes: accelerate / steer, integrate or collide, render
+//  optional occupancy grid (one bit per layer pixel) for pixel exact collisions with other particles and barriers
+//  no per layer particle budget: each effect binds its own max (at most 255 by their controls)
+struct Particles {
+  static constexpr int32_t one = 1 << 16; //1 pixel
+
+  uint16_t capacity = 0;
+  uint16_t *count = nullptr;
+  int32_t *pos[3]; //x, y, z
+  int32_t *vel[3]; //added to pos each step
+  uint8_t *colorIndex;
+  uint16_t *life; //free to use by the effect, e.g. brightness or frames to live
+  uint32_t *drawn; //unprojected index of the pixel the particle is drawn on, UINT32_MAX if not drawn
+  uint32_t *grid = nullptr; //occupied pixels
+
+  //binds the arrays in effectData, same place in each loop. capacity is the max number of particles of the effect
+  bool bind(LedsLayer &leds, uint16_t capacity, bool withGrid = false) {
+    this->capacity = capacity;
+    count = leds.effectData.readWrite<uint16_t>();
+    for (int a = 0; a < 3; a++) pos[a] = leds.effectData.readWrite<int32_t>(this->capacity);
+    for (int a = 0; a < 3; a++) vel[a] = leds.effectData.readWrite<int32_t>(this->capacity);
+    colorIndex = leds.effectData.readWrite<uint8_t>(this->capacity);
+    life = leds.effectData.readWrite<uint16_t>(this->capacity);
+    drawn = leds.effectData.readWrite<uint32_t>(this->capacity);
+    if (withGrid) grid = leds.effectData.readWrite<uint32_t>(gridWords(leds));
+    if (!leds.effectData.success()) return false;
+    if (*count > this->capacity) *count = this->capacity;
+    return true;
+  }
+
+  static size_t gridWords(const LedsLayer &leds) {return (leds.size.x * leds.size.y * leds.size.z + 31) / 32;}
+
+  //removes all particles (not their pixels)
+  void clear(const LedsLayer &leds) {
+    *count = 0;
+    if (grid) memset(grid, 0, gridWords(leds) * sizeof(uint32_t));
+  }
+
+  static int toPixel(int32_t value) {return (value + one / 2) >> 16;} //rounded
+  Coord3D pixel(uint16_t i) const {return Coord3D{toPixel(pos[0][i]), toPixel(pos[1][i]), toPixel(pos[2][i])};}
+
+  //position and velocity in fixed point, returns UINT16_MAX if full
+  uint16_t add(int32_t x, int32_t y, int32_t z, int32_t vx, int32_t vy, int32_t vz, uint8_t colorIndex, uint16_t life = 0) {
+    if (*count >= capacity) return UINT16_MAX;
+    uint16_t i = (*count)++;
+    pos[0][i] = x; pos[1][i] = y; pos[2][i] = z;
+    vel[0][i] = vx; vel[1][i] = vy; vel[2][i] = vz;
+    this->colorIndex[i] = colorIndex;
+    this->life[i] = life;
+    drawn[i] = UINT32_MAX;
+    return i;
+  }
+
+  //the last particle takes its place
+  void remove(uint16_t i) {
+    uint16_t last = --(*count);
+    for (int a = 0; a < 3; a++) {pos[a][i] = pos[a][last]; vel[a][i] = vel[a][last];}
+    colorIndex[i] = colorIndex[last];
+    life[i] = life[last];
+    drawn[i] = drawn[last];
+  }
+
+  void accelerate(int32_t ax, int32_t ay, int32_t az) {
+    int32_t acc[3] = {ax, ay, az};
+    for (int a = 0; a < 3; a++) if (acc[a]) for (uint16_t i = 0; i < *count; i++) vel[a][i] += acc[a];
+  }
+
+  //velocities towards target velocity by factor / 256
+  void steer(int32_t tx, int32_t ty, int32_t tz, uint8_t factor) {
+    int32_t target[3] = {tx, ty, tz};
+    for (int a = 0; a < 3; a++) for (uint16_t i = 0; i < *count; i++) vel[a][i] += (int64_t)(target[a] - vel[a][i]) * factor / 256;
+  }
+
+  void integrate() {
+    for (int a = 0; a < 3; a++) for (uint16_t i = 0; i < *count; i++) pos[a][i] += vel[a][i];
+  }
+
+  //time based: velocities times numerator / denominator, e.g. elapsed ms / 1000 for velocities in pixels per second
+  void integrate(int32_t numerator, int32_t denominator) {
+    for (int a = 0; a < 3; a++) for (uint16_t i = 0; i < *count; i++) pos[a][i] += (int64_t)vel[a][i] * numerator / denominator;
+  }
+
+  //occupancy grid
+  int gridIndex(const LedsLayer &leds, const Coord3D &pixel) const {
+    return pixel.isOutofBounds(leds.size)?-1:leds.XYZUnprojected(pixel);
+  }
+  bool isOccupied(const LedsLayer &leds, const Coord3D &pixel) const {
+    int i = gridIndex(leds, pixel);
+    return grid && i >= 0 && ((grid[i >> 5] >> (i & 31)) & 1);
+  }
+  void setOccupied(const LedsLayer &leds, const Coord3D &pixel, bool value) {
+    int i = gridIndex(leds, pixel);
+    if (!grid || i < 0) return;
+    if (value) grid[i >> 5] |= 1u << (i & 31); else grid[i >> 5] &= ~(1u << (i & 31));
+  }
+  //inside the layer, a mapped pixel and not occupied
+  bool isFree(const LedsLayer &leds, const Coord3D &pixel) const {
+    return !pixel.isOutofBounds(leds.size) && leds.isMapped(leds.XYZUnprojected(pixel)) && !isOccupied(leds, pixel);
+  }
+
+  //integrate with pixel exact collisions (uses the grid): a particle which would enter a pixel which is not free
+  //moves to the nearest free neighbor pixel instead or stops in the blocked directions
+  void collide(const LedsLayer &leds) {
+    for (uint16_t i = 0; i < *count; i++) {
+      Coord3D prevPos = pixel(i);
+      for (int a = 0; a < 3; a++) pos[a][i] += vel[a][i];
+      Coord3D newPos = pixel(i);
+      if (newPos == prevPos) continue;
+
+      if (!isFree(leds, newPos)) {
+        Coord3D nearest = prevPos;
+        unsigned nearestDist = newPos.distanceSquared(prevPos);
+        int diff = 0; //if distance the same, more different coordinates is better
+        bool changed = false;
+        for (int dx = -1; dx <= 1; dx++) for (int dy = -1; dy <= 1; dy++) for (int dz = -1; dz <= 1; dz++) {
+          Coord3D testPos = newPos + Coord3D{dx, dy, dz};
+          if (testPos == prevPos || !isFree(leds, testPos)) continue;
+          unsigned dist = testPos.distanceSquared(newPos);
+          int differences = (prevPos.x != testPos.x) + (prevPos.y != testPos.y) + (prevPos.z != testPos.z);
+          if (dist < nearestDist || (dist == nearestDist && differences >= diff)) {
+            nearestDist = dist;
+            nearest = testPos;
+            diff = differences;
+            changed = true;
+          }
+        }
+        if (changed) { //move towards nearest free pixel
+          int prev[3] = {prevPos.x, prevPos.y, prevPos.z};
+          int next[3] = {nearest.x, nearest.y, nearest.z};
+          int wanted[3] = {newPos.x, newPos.y, newPos.z};
+          for (int a = 0; a < 3; a++) {
+            if (wanted[a] != next[a]) vel[a][i] = constrain(next[a] - prev[a], -1, 1) * one;
+            pos[a][i] = next[a] * one;
+          }
+        }
+        else { //stay, stop in the directions which are blocked
+          for (int a = 0; a < 3; a++) pos[a][i] -= vel[a][i];
+          Coord3D testing = pixel(i);
+          testing.x = newPos.x;
+          if (testing.isOutofBounds(leds.size) || !leds.isMapped(leds.XYZUnprojected(testing))) vel[0][i] = 0;
+          testing = pixel(i);
+          testing.y = newPos.y;
+          if (testing.isOutofBounds(leds.size) || !leds.isMapped(leds.XYZUnprojected(testing))) vel[1][i] = 0;
+          testing = pixel(i);
+          testing.z = newPos.z;
+          if (testing.isOutofBounds(leds.size) || !leds.isMapped(leds.XYZUnprojected(testing))) vel[2][i] = 0;
+        }
+      }
+      setOccupied(leds, prevPos, false);
+      setOccupied(leds, pixel(i), true);
+    }
+  }
+
+  //clears the pixels particles left and draws all particles, no fill of the layer needed
+  void render(LedsLayer &leds) {
+    for (uint16_t i = 0; i < *count; i++) {
+      Coord3D p = pixel(i);
+      if (drawn[i] != UINT32_MAX && (p.isOutofBounds(leds.size) || drawn[i] != (uint32_t)leds.XYZUnprojected(p)))
+        leds.setPixelColor(unprojected(leds, drawn[i]), CRGB::Black);
+    }
+    for (uint16_t i = 0; i < *count; i++) {
+      Coord3D p = pixel(i);
+      if (p.isOutofBounds(leds.size)) {drawn[i] = UINT32_MAX; continue;}
+      leds.setPixelColor(p, ColorFromPalette(leds.palette, colorIndex[i]));
+      drawn[i] = leds.XYZUnprojected(p);
+    }
+  }
+
+  static Coord3D unprojected(const LedsLayer &leds, uint32_t index) {
+    return Coord3D{int(index % leds.size.x), int(index / leds.size.x % leds.size.y), int(index / (leds.size.x * leds.size.y))};
+  }
+};
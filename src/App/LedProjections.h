@@ -212,10 +212,11 @@ class PinwheelProjection: public Projection {
     const int symmetry = FACTORS[leds.projectionData.read<uint8_t>()-1];
     const int zTwist   = leds.projectionData.read<uint8_t>();
          
-    const int dx = pixel.x - leds.middle.x;
-    const int dy = pixel.y - leds.middle.y;
-    const int swirlFactor = swirlVal == 0 ? 0 : hypot(dy, dx) * abs(swirlVal); // Only calculate if swirlVal != 0
-    int angle = degrees(atan2(dy, dx)) + 180;  // 0 - 360
+    // polar map of the layer before addPixelsPre resized it, kept over remaps (e.g. changing swirl or petals)
+    const RadialField &field = leds.radial(Coord3D{2 * leds.middle.x, 2 * leds.middle.y, 0}, Coord3D{leds.end.x - leds.start.x + 1, leds.end.y - leds.start.y + 1, 1}, RadialField::byProjection);
+    const RadialField::Polar &polar = field.at(Coord3D{pixel.x, pixel.y, 0});
+    const int swirlFactor = swirlVal == 0 ? 0 : polar.distance * abs(swirlVal) / 16; // Only calculate if swirlVal != 0
+    int angle = (int16_t)polar.angle * 180 / 32768 + 180;  // 0 - 360
     
     if (swirlVal < 0) angle = 360 - angle; // Reverse Swirl
 
@@ -229,7 +230,7 @@ class PinwheelProjection: public Projection {
     pixel.x = value;
     pixel.y = 0;
     if (leds.effectDimension > _1D && leds.projectionDimension > _1D) {
-      pixel.y = int(sqrt(sq(dx) + sq(dy))); // Round produced blank pixel
+      pixel.y = polar.distance / 16; // Round produced blank pixel
     }
     pixel.z = 0;
 
@@ -336,6 +337,28 @@ class TiltPanRollProjection: public Projection {
         return true;
       default: return false;
     }});
+    pixelCacheSetup(leds, parentVar);
+  }
+
+  //shared with RotateProjection
+  static void pixelCacheSetup(LedsLayer &leds, Variable parentVar) {
+    ui->initCheckBox(parentVar, "pixelCache", (bool3State)false, false, [&leds](EventArguments) { switch (eventType) {
+      case onUI:
+        variable.setComment("Reuse projected pixels if not rotating");
+        return true;
+      case onChange:
+        leds.proPixels.enabled = variable.getValue(rowNr);
+        leds.proPixels.invalidate(leds.size.x * leds.size.y * leds.size.z);
+        return true;
+      default: return false;
+    }});
+  }
+
+  //invalidates the pixel cache if the rotation changed or the layer resized
+  static void pixelCacheLoop(LedsLayer &leds, bool changed) {
+    size_t nrOfPixels = leds.size.x * leds.size.y * leds.size.z;
+    if (changed || leds.proPixels.pixels.size() != (leds.proPixels.enabled?nrOfPixels:0))
+      leds.proPixels.invalidate(nrOfPixels);
   }
 
   void addPixel(LedsLayer &leds, Coord3D &pixel) override {
@@ -355,21 +378,40 @@ class TiltPanRollProjection: public Projection {
     pixel.z += offset.z;
   }
 
-  void XYZ(LedsLayer &leds, Coord3D &pixel) override {
+  //one rotation matrix per frame instead of tilt, pan and roll per pixel, set before the effect draws
+  void loopPre(LedsLayer &leds) override {
+    uint16_t tilt, pan, roll;
     #ifdef STARBASE_USERMOD_MPU6050
       if (leds.proGyro) {
-        pixel = trigoTiltPanRoll.tilt(pixel, leds.size/2, mpu6050->gyro.x);
-        pixel = trigoTiltPanRoll.pan(pixel, leds.size/2, mpu6050->gyro.y);
-        pixel = trigoTiltPanRoll.roll(pixel, leds.size/2, mpu6050->gyro.z);
+        tilt = trigoTiltPanRoll.binaryAngle(mpu6050->gyro.x);
+        pan = trigoTiltPanRoll.binaryAngle(mpu6050->gyro.y);
+        roll = trigoTiltPanRoll.binaryAngle(mpu6050->gyro.z);
       }
       else 
     #endif
     {
-      if (leds.proTiltSpeed) pixel = trigoTiltPanRoll.tilt(pixel, leds.size/2, sys->now * 5 / (255 - leds.proTiltSpeed));
-      if (leds.proPanSpeed) pixel = trigoTiltPanRoll.pan(pixel, leds.size/2, sys->now * 5 / (255 - leds.proPanSpeed));
-      if (leds.proRollSpeed) pixel = trigoTiltPanRoll.roll(pixel, leds.size/2, sys->now * 5 / (255 - leds.proRollSpeed));
-      if (fix->fixSize.z == 1) pixel.z = 0; // 3d effects will be flattened on 2D fixtures
+      tilt = leds.proTiltSpeed?trigoTiltPanRoll.binaryAngle(sys->now * 5 / (255 - leds.proTiltSpeed)):0;
+      pan = leds.proPanSpeed?trigoTiltPanRoll.binaryAngle(sys->now * 5 / (255 - leds.proPanSpeed)):0;
+      roll = leds.proRollSpeed?trigoTiltPanRoll.binaryAngle(sys->now * 5 / (255 - leds.proRollSpeed)):0;
     }
+    pixelCacheLoop(leds, leds.proRotation.set(tilt, pan, roll));
+  }
+
+  bool hasXYZ() override {return true;}
+
+  void XYZ(LedsLayer &leds, Coord3D &pixel) override {
+    int i = leds.proPixels.index(pixel, leds.size);
+    if (leds.proPixels.get(i, pixel)) return;
+
+    pixel = leds.proRotation.apply(pixel, leds.size/2);
+
+    bool flatten = fix->fixSize.z == 1; // 3d effects will be flattened on 2D fixtures
+    #ifdef STARBASE_USERMOD_MPU6050
+      if (leds.proGyro) flatten = false;
+    #endif
+    if (flatten) pixel.z = 0;
+
+    leds.proPixels.set(i, pixel);
   }
 }; //TiltPanRollProjection
 
@@ -459,6 +501,13 @@ class Preset1Projection: public Projection {
     dp.addPixel(leds, pixel);
   }
 
+  void loopPre(LedsLayer &leds) override {
+    TiltPanRollProjection tp;
+    tp.loopPre(leds);
+  }
+
+  bool hasXYZ() override {return true;}
+
   void XYZ(LedsLayer &leds, Coord3D &pixel) override {
     TiltPanRollProjection tp;
     tp.XYZ(leds, pixel);
@@ -472,6 +521,8 @@ class RandomProjection: public Projection {
   void setup(LedsLayer &leds, Variable parentVar) override {
   }
 
+  bool hasXYZ() override {return true;}
+
   void XYZ(LedsLayer &leds, Coord3D &pixel) override {
     pixel = Coord3D({random(leds.size.x), random(leds.size.y), random(leds.size.z)})  ;
   }
@@ -880,6 +931,8 @@ class ScrollingProjection: public Projection {
     mp.addPixel(leds, pixel);
   }
 
+  bool hasXYZ() override {return true;}
+
   void XYZ(LedsLayer &leds, Coord3D &pixel) override {
     bool3State mirrorX = leds.projectionData.read<bool3State>(); // Not used 
     bool3State mirrorY = leds.projectionData.read<bool3State>(); // Not used
@@ -918,6 +971,8 @@ class AccelerationProjection: public Projection {
     dp.addPixel(leds, pixel);
   }
 
+  bool hasXYZ() override {return true;}
+
   void XYZ(LedsLayer &leds, Coord3D &pixel) override {
     bool3State wrap = leds.projectionData.read<bool3State>();
     float sensitivity = float(leds.projectionData.read<uint8_t>()) / 20.0 + 1; // 0 - 100 slider -> 1.0 - 6.0 multiplier 
@@ -1062,6 +1117,7 @@ class RotateProjection: public Projection {
         return true;
       default: return false;
     }});
+    TiltPanRollProjection::pixelCacheSetup(leds, parentVar);
   }
 
   void addPixelsPre(LedsLayer &leds) override {
@@ -1097,12 +1153,14 @@ class RotateProjection: public Projection {
     dp.addPixel(leds, pixel);
   }
 
-  void XYZ(LedsLayer &leds, Coord3D &pixel) override {
-    RotateData *data = leds.projectionData.readWrite<RotateData>();
+  static constexpr int Fixed_Scale = 1 << 10;
 
-    constexpr int Fixed_Scale = 1 << 10;
+  //angle and shear are updated once per frame, not per pixel, before the effect draws
+  void loopPre(LedsLayer &leds) override {
+    RotateData *data = leds.projectionData.readWrite<RotateData>();
 
-    if ((sys->now - data->lastUpdate > data->interval) && data->speed) { // Only update if the angle has changed
+    bool changed = (sys->now - data->lastUpdate > data->interval) && data->speed;
+    if (changed) { // Only update if the angle has changed
       data->lastUpdate = sys->now;
       // Increment the angle
       data->angle = data->reverse ? (data->angle <= 0 ? 359 : data->angle - 1) : (data->angle >= 359 ? 0 : data->angle + 1);
@@ -1119,6 +1177,16 @@ class RotateProjection: public Projection {
       data->shearX = -tan(angleRadians / 2) * Fixed_Scale;
       data->shearY =  sin(angleRadians)     * Fixed_Scale;
     }
+    TiltPanRollProjection::pixelCacheLoop(leds, changed);
+  }
+
+  bool hasXYZ() override {return true;}
+
+  void XYZ(LedsLayer &leds, Coord3D &pixel) override {
+    RotateData *data = leds.projectionData.readWrite<RotateData>();
+
+    int i = leds.proPixels.index(pixel, leds.size);
+    if (leds.proPixels.get(i, pixel)) return;
 
     int maxX = leds.size.x;
     int maxY = leds.size.y;
@@ -1148,6 +1216,8 @@ class RotateProjection: public Projection {
     else if (pixel.x >= maxX) pixel.x = maxX - 1;
     if      (pixel.y < 0)     pixel.y = 0;
     else if (pixel.y >= maxY) pixel.y = maxY - 1;
+
+    leds.proPixels.set(i, pixel);
   }
 }; //RotateProjection
 
@@ -137,6 +137,11 @@ bool SysModFiles::remove(const char * path) {
   filesChanged = true;
 }
 
+bool SysModFiles::rename(const char * pathFrom, const char * pathTo) {
+  filesChanged = true;
+  return LittleFS.rename(pathFrom, pathTo); //littlefs: atomic, replaces pathTo if it exists
+}
+
 size_t SysModFiles::usedBytes() {
   return LittleFS.usedBytes();
 }
@@ -254,12 +259,14 @@ bool SysModFiles::readObjectFromFile(const char* path, JsonDocument* dest) {
 }
 
 bool SysModFiles::writeObjectToFile(const char* path, JsonDocument* dest) {
-  File f = open(path, FILE_WRITE);
+  //write to a temp file first so a reset during writing does not corrupt path
+  char tmpPath[64];
+  print->fFormat(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+  File f = open(tmpPath, FILE_WRITE);
   if (f) {
     serializeJson(*dest, f);
     f.close();
-    filesChanged = true;
-    return true;
+    return rename(tmpPath, path);
   } else {
     ppf("File %s open not successful\n", path);
     return false;
@@ -31,6 +31,9 @@ public:
 
   bool remove(const char * path);
 
+  //replaces pathTo if it exists
+  bool rename(const char * pathFrom, const char * pathTo);
+
   size_t usedBytes();
 
   size_t totalBytes();
@@ -15,6 +15,7 @@
 #include "SysStarJson.h"
 #include "SysModUI.h"
 #include "SysModInstances.h"
+#include "SysModSystem.h"
 
   Variable::Variable() {
     var = JsonObject(); //undefined variable
@@ -140,6 +141,8 @@
 
     //post update details
     web->getResponseObject()["details"]["var"] = var;
+
+    mdl->compactModel(); //removed controls
   }
 
   bool Variable::triggerEvent(uint8_t eventType, uint8_t rowNr, bool init) {
@@ -520,6 +523,160 @@
     return false;
   }
 
+void* Arena_Allocator::allocate(size_t size) {
+  Lock lock(mutex);
+  size = align(size);
+
+  //first fit in existing arenas
+  for (Arena &arena: arenas) {
+    byte *end = arena.memory + arena.size;
+    for (BlockHeader *block = (BlockHeader *)arena.memory; (byte *)block < end; block = next(block)) {
+      if (!block->used) {
+        mergeNext(arena, block);
+        if (block->size >= size) {
+          split(block, size);
+          block->used = true;
+          return (byte *)block + sizeof(BlockHeader);
+        }
+      }
+    }
+  }
+
+  //new arena
+  Arena arena;
+  arena.size = (size + sizeof(BlockHeader) > arenaSize)?size + sizeof(BlockHeader):arenaSize;
+  arena.memory = (byte *)ramAllocator.allocate(arena.size);
+  if (arena.memory == nullptr) {
+    ppf("dev arena allocation of %d bytes failed\n", arena.size);
+    return nullptr;
+  }
+  arenas.push_back(arena);
+
+  BlockHeader *block = (BlockHeader *)arena.memory;
+  block->size = arena.size - sizeof(BlockHeader);
+  block->used = true;
+  split(block, size);
+  return (byte *)block + sizeof(BlockHeader);
+}
+
+void Arena_Allocator::deallocate(void* pointer) {
+  if (pointer == nullptr) return;
+  Lock lock(mutex);
+  Arena *arena = findArena(pointer);
+  if (arena == nullptr) {
+    ppf("dev arena deallocate unknown pointer %p\n", pointer);
+    return;
+  }
+  BlockHeader *block = (BlockHeader *)((byte *)pointer - sizeof(BlockHeader));
+  block->used = false;
+  mergeNext(*arena, block);
+}
+
+void* Arena_Allocator::reallocate(void* ptr, size_t new_size) {
+  if (ptr == nullptr) return allocate(new_size);
+  Lock lock(mutex);
+
+  Arena *arena = findArena(ptr);
+  if (arena == nullptr) {
+    ppf("dev arena reallocate unknown pointer %p\n", ptr);
+    return nullptr;
+  }
+  BlockHeader *block = (BlockHeader *)((byte *)ptr - sizeof(BlockHeader));
+  size_t size = align(new_size);
+
+  //shrink or grow in place (ArduinoJson expects shrinkToFit to keep the pool in place)
+  if (block->size < size) mergeNext(*arena, block); //take the free blocks after it
+  if (block->size >= size) {
+    split(block, size);
+    return ptr;
+  }
+
+  //move
+  void *newPtr = allocate(new_size);
+  if (newPtr != nullptr) {
+    memcpy(newPtr, ptr, block->size);
+    deallocate(ptr);
+  }
+  return newPtr;
+}
+
+size_t Arena_Allocator::compact() {
+  Lock lock(mutex);
+  size_t released = 0;
+  for (std::vector<Arena>::iterator arena = arenas.begin(); arena != arenas.end(); ) {
+    BlockHeader *first = (BlockHeader *)arena->memory;
+    for (BlockHeader *block = first; (byte *)block < arena->memory + arena->size; block = next(block)) {
+      if (!block->used) mergeNext(*arena, block);
+    }
+    //one free block spanning the whole arena: give it back (keep the last arena to avoid malloc/free ping pong)
+    if (!first->used && first->size + sizeof(BlockHeader) == arena->size && arenas.size() > 1) {
+      released += arena->size;
+      ramAllocator.deallocate(arena->memory);
+      arena = arenas.erase(arena);
+    }
+    else
+      ++arena;
+  }
+  arenas.shrink_to_fit();
+  return released;
+}
+
+size_t Arena_Allocator::bytesReserved() const {
+  Lock lock(mutex);
+  size_t total = 0;
+  for (const Arena &arena: arenas) total += arena.size;
+  return total;
+}
+
+size_t Arena_Allocator::bytesUsed() const {
+  Lock lock(mutex);
+  size_t total = 0;
+  for (const Arena &arena: arenas) {
+    for (BlockHeader *block = (BlockHeader *)arena.memory; (byte *)block < arena.memory + arena.size; block = next(block))
+      if (block->used) total += block->size + sizeof(BlockHeader);
+  }
+  return total;
+}
+
+size_t Arena_Allocator::largestFree() const {
+  Lock lock(mutex);
+  size_t largest = 0;
+  for (const Arena &arena: arenas) {
+    size_t run = 0; //adjacent free blocks count as one as they will be merged
+    for (BlockHeader *block = (BlockHeader *)arena.memory; (byte *)block < arena.memory + arena.size; block = next(block)) {
+      if (block->used) run = 0;
+      else {
+        run += run?block->size + sizeof(BlockHeader):block->size;
+        largest = max(largest, run);
+      }
+    }
+  }
+  return largest;
+}
+
+//split block in a block of size and a free remainder, if the remainder is worth it
+void Arena_Allocator::split(BlockHeader *block, size_t size) {
+  if (block->size >= size + sizeof(BlockHeader) + 16) {
+    BlockHeader *remainder = (BlockHeader *)((byte *)block + sizeof(BlockHeader) + size);
+    remainder->size = block->size - size - sizeof(BlockHeader);
+    remainder->used = false;
+    block->size = size;
+  }
+}
+
+//merge all free blocks following block into block
+void Arena_Allocator::mergeNext(Arena &arena, BlockHeader *block) {
+  byte *end = arena.memory + arena.size;
+  for (BlockHeader *nextBlock = next(block); (byte *)nextBlock < end && !nextBlock->used; nextBlock = next(block))
+    block->size += sizeof(BlockHeader) + nextBlock->size;
+}
+
+Arena_Allocator::Arena *Arena_Allocator::findArena(void *pointer) {
+  for (Arena &arena: arenas)
+    if ((byte *)pointer > arena.memory && (byte *)pointer < arena.memory + arena.size) return &arena;
+  return nullptr;
+}
+
 SysModModel::SysModModel() :SysModule("Model") {
   model = new JsonDocument(&allocator);
   presets = new JsonDocument(&allocator);
@@ -554,6 +711,33 @@ void SysModModel::setup() {
     default: return false;
   }});
 
+  ui->initNumber(parentVar, "saveDelay", &saveDelay, 0, 10000, false, [](EventArguments) { switch (eventType) {
+    case onUI:
+      variable.setComment("ms, saves within this time are combined");
+      return true;
+    default: return false;
+  }});
+
+  ui->initText(parentVar, "saves", nullptr, 32, true, [this](EventArguments) { switch (eventType) {
+    case onUI:
+      variable.setComment("Written (skipped) KB, last (max) latency");
+      return true;
+    case onLoop1s:
+      variable.setValueF("%d (%d) %d KB %d (%d) ms", writesDone, writesSkipped, bytesWritten / 1024, writeLatency, writeLatencyMax);
+      return true;
+    default: return false;
+  }});
+
+  ui->initText(parentVar, "memory", nullptr, 32, true, [this](EventArguments) { switch (eventType) {
+    case onUI:
+      variable.setComment("Used / reserved in arenas, largest free block");
+      return true;
+    case onLoop1s:
+      variable.setValueF("%d / %d B (%d) %d KB", allocator.bytesUsed(), allocator.bytesReserved(), allocator.nrOfArenas(), allocator.largestFree() / 1024);
+      return true;
+    default: return false;
+  }});
+
   #ifdef STARBASE_DEVMODE
 
   ui->initCheckBox(parentVar, "showObsolete", (bool3State)false, false, [this](EventArguments) { switch (eventType) {
@@ -593,31 +777,87 @@ void SysModModel::loop20ms() {
   if (!cleanUpModelDone) { //do after all setups
     cleanUpModelDone = true;
     cleanUpModel();
+    compactModel();
   }
 
-  if (doWriteModel) {
-    ppf("Writing model to /model.json... (serializeConfig)\n");
+  if (doWriteModel) { //explicit save: right away, this also writes a pending automatic write
+    doWriteModel = false;
+    writePending = false;
+    writeModel();
+  }
+  //coalesced writes: write if no new request during saveDelay, but not later than 10 x saveDelay after the first one
+  if (writePending && (sys->now - writeLastRequest >= saveDelay || sys->now - writeFirstRequest >= 10 * saveDelay))
+    flushModel();
+}
 
-    // files->writeObjectToFile("/model.json", model);
+void SysModModel::requestWriteModel() {
+  if (!writePending) writeFirstRequest = sys->now;
+  writeLastRequest = sys->now;
+  writePending = true;
+}
 
-    cleanUpModel(Variable(), false, true);//remove if var["o"] is negative (not cleanedUp) and remove ro values
+void SysModModel::flushModel() {
+  if (!writePending) return;
+  writePending = false;
+  writeModel();
+}
 
-    StarJson starJson("/model.json", FILE_WRITE); //open fileName for deserialize
-    //comment exclusions out in case of generating model.json for github
-    starJson.addExclusion("fun");
-    starJson.addExclusion("dash");
-    starJson.addExclusion("o"); //order: this must be deleted as it will be used to check on reboot 
-    starJson.addExclusion("p"); //pointer
-    starJson.addExclusion("oldValue");
-    starJson.writeJsonDocToFile(model);
+void SysModModel::writeModel() {
+  unsigned long start = millis();
 
-    // print->printJson("Write model", *model); //this shows the model before exclusion
+  cleanUpModel(Variable(), false, true);//remove if var["o"] is negative (not cleanedUp) and remove ro values
+  compactModel();
 
-    if (!presets->isNull())
-      files->writeObjectToFile("/presets.json", presets);
+  StarJson starJson(nullptr); //no file, writeJsonDocToPrint only
+  //comment exclusions out in case of generating model.json for github
+  starJson.addExclusion("fun");
+  starJson.addExclusion("dash");
+  starJson.addExclusion("o"); //order: this must be deleted as it will be used to check on reboot 
+  starJson.addExclusion("p"); //pointer
+  starJson.addExclusion("oldValue");
 
+  //only write to flash if the result differs from the last write
+  HashPrint modelPrint;
+  starJson.writeJsonDocToPrint(model, modelPrint);
+  HashPrint presetsPrint;
+  if (!presets->isNull()) serializeJson(*presets, presetsPrint);
 
-    doWriteModel = false;
+  bool written = false;
+  if (modelPrint.hash != modelHash) {
+    ppf("Writing model to /model.json... (serializeConfig)\n");
+    File f = files->open("/model.json.tmp", FILE_WRITE);
+    if (f) {
+      starJson.writeJsonDocToPrint(model, f);
+      f.close();
+      //atomic: a reset during writing leaves the old model.json intact
+      if (files->rename("/model.json.tmp", "/model.json")) {
+        modelHash = modelPrint.hash;
+        bytesWritten += modelPrint.length;
+        written = true;
+      }
+    }
+    else
+      ppf("File /model.json.tmp open not successful\n");
+  }
+
+  // print->printJson("Write model", *model); //this shows the model before exclusion
+
+  if (!presets->isNull() && presetsPrint.hash != presetsHash) {
+    if (files->writeObjectToFile("/presets.json", presets)) { //also atomic
+      presetsHash = presetsPrint.hash;
+      bytesWritten += presetsPrint.length;
+      written = true;
+    }
+  }
+
+  if (written) {
+    writesDone++;
+    writeLatency = millis() - start;
+    writeLatencyMax = max(writeLatencyMax, writeLatency);
+  }
+  else {
+    writesSkipped++;
+    ppf("model.json and presets.json unchanged, not written\n");
   }
 }
 
@@ -676,6 +916,15 @@ void SysModModel::cleanUpModel(Variable parent, bool oPos, bool ro) {
   }
 }
 
+void SysModModel::compactModel() {
+  //only worth it if at least half of the reserved arenas is unused: shrinkToFit reallocates the pools, doing that on each effect switch or write churns the arenas
+  if (allocator.nrOfArenas() < 2 || allocator.bytesUsed() * 2 > allocator.bytesReserved()) return;
+  model->shrinkToFit();
+  presets->shrinkToFit();
+  size_t released = allocator.compact();
+  if (released) ppf("compactModel released %d bytes, %d arenas %d / %d bytes used\n", released, allocator.nrOfArenas(), allocator.bytesUsed(), allocator.bytesReserved());
+}
+
 Variable SysModModel::initVar(Variable parent, const char * id, const char * type, bool readOnly, const VarEvent &varEvent) {
   const char * parentId = parent.var["id"];
   if (!parentId) parentId = "m"; //m=module
@@ -199,6 +199,55 @@ struct RAM_Allocator: ArduinoJson::Allocator {
   }
 };
 
+//Region allocator for the model: ArduinoJson pools and strings are carved out of a few big arenas (taken from RAM_Allocator)
+//so adding and removing (effect) variables does not fragment the heap. Free blocks are reused first fit,
+//compact() merges free blocks and gives empty arenas back to the heap (call after cleanUpModel)
+//The arena bookkeeping is guarded by a recursive mutex as malloc was thread safe: the async web task allocates from the same documents
+struct Arena_Allocator: ArduinoJson::Allocator {
+  static const size_t arenaSize = 8192; //bytes, allocations larger than this get an arena of their own
+
+  void* allocate(size_t size) override;
+  void deallocate(void* pointer) override;
+  void* reallocate(void* ptr, size_t new_size) override;
+
+  //merge adjacent free blocks and release empty arenas, returns the nr of bytes given back to the heap
+  size_t compact();
+
+  //statistics
+  size_t nrOfArenas() const {return arenas.size();}
+  size_t bytesReserved() const;
+  size_t bytesUsed() const;
+  size_t largestFree() const;
+
+private:
+  //8 byte header in front of each block, blocks are 8 byte aligned
+  struct BlockHeader {
+    uint32_t size; //of the block excluding header
+    uint32_t used;
+  };
+  struct Arena {
+    byte *memory;
+    size_t size;
+  };
+
+  RAM_Allocator ramAllocator;
+  std::vector<Arena> arenas;
+  SemaphoreHandle_t mutex = xSemaphoreCreateRecursiveMutex(); //recursive: reallocate calls allocate and deallocate
+
+  //take the mutex for the lifetime of the guard
+  struct Lock {
+    SemaphoreHandle_t mutex;
+    Lock(SemaphoreHandle_t mutex): mutex(mutex) {xSemaphoreTakeRecursive(mutex, portMAX_DELAY);}
+    ~Lock() {xSemaphoreGiveRecursive(mutex);}
+  };
+
+  static size_t align(size_t size) {return (size + 7) & ~7;}
+  static BlockHeader *next(BlockHeader *block) {return (BlockHeader *)((byte *)block + sizeof(BlockHeader) + block->size);}
+  void split(BlockHeader *block, size_t size);
+  void mergeNext(Arena &arena, BlockHeader *block);
+  Arena *findArena(void *pointer);
+};
+
 enum eventTypes
 {
   onSetValue,
@@ -372,11 +421,24 @@ class SysModModel: public SysModule {
 
 public:
 
-  RAM_Allocator allocator;
+  Arena_Allocator allocator;
   JsonDocument *model = nullptr;
   JsonDocument *presets = nullptr;
 
-  bool doWriteModel = false;
+  bool doWriteModel = false; //explicit save: model.json is written in the next loop20ms
+  uint16_t saveDelay = 1000; //ms
+
+  //automatic writes (e.g. presets) are coalesced: written saveDelay ms after the last request
+  void requestWriteModel();
+  //write a coalesced write now, e.g. before a restart
+  void flushModel();
+
+  //persistence statistics (flash wear and write latency)
+  unsigned writesDone = 0;
+  unsigned writesSkipped = 0; //nothing changed since last write
+  size_t bytesWritten = 0;
+  unsigned long writeLatency = 0; //ms
+  unsigned long writeLatencyMax = 0;
 
   uint8_t setValueRowNr = UINT8_MAX;
   uint8_t getValueRowNr = UINT8_MAX;
@@ -396,6 +458,9 @@ public:
   //scan all vars in the model and remove vars where var["o"] is negative or positive, if ro then remove ro values
   void cleanUpModel(Variable parent = Variable(), bool oPos = true, bool ro = false);
 
+  //give memory of removed vars back: shrink the json pools and compact the arenas
+  void compactModel();
+
   //sets the value of var with id
   template <typename Type>
   void setValue(const char * pid, const char * id, Type value, uint8_t rowNr = UINT8_MAX) {
@@ -443,6 +508,15 @@ public:
 private:
   bool cleanUpModelDone = false;
 
+  bool writePending = false;
+  unsigned long writeFirstRequest = 0;
+  unsigned long writeLastRequest = 0;
+  uint32_t modelHash = 0; //of the last written model.json
+  uint32_t presetsHash = 0;
+
+  //write model.json (atomic via temp file) and presets.json if they changed
+  void writeModel();
+
 };
 
 extern SysModModel *mdl;
\ No newline at end of file
@@ -96,6 +96,7 @@ void SysModSystem::setup() {
       //   yield();        // enough time to send response to client
       // }
       // FASTLED.clear();
+      mdl->flushModel(); //coalesced writes are not lost
       ESP.restart();
       return true;
     default: return false;
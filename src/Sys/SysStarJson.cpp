@@ -19,9 +19,11 @@
 //only support what is currently needed: read / deserialize uint8/16/char var elements (arrays not yet)
   StarJson::StarJson(const char * path, const char * mode) {
     // ppf("StarJson constructing %s %s\n", path, mode);
+    if (path == nullptr) return; //only writeJsonDocToPrint
     f = files->open(path, mode);
     if (!f)
       ppf("StarJson open %s for %s failed", path, mode);
+    out = &f;
   }
 
   StarJson::~StarJson() {
@@ -40,6 +42,13 @@
     files->filesChanged = true;
   }
 
+  void StarJson::writeJsonDocToPrint(JsonDocument* dest, Print &print) {
+    Print *outFile = out;
+    out = &print;
+    writeJsonVariantToFile(dest->as<JsonVariant>());
+    out = outFile;
+  }
+
   void StarJson::lookFor(const char * id, uint8_t * value) {
     uint8List.push_back(value);
     addToVars(id, "uint8", uint8List.size()-1);
@@ -217,7 +226,7 @@
   //writeJsonVariantToFile calls itself recursively until whole json document has been parsed
   void StarJson::writeJsonVariantToFile(JsonVariant variant) {
     if (variant.is<JsonObject>()) {
-      f.printf("{");
+      out->printf("{");
       char sep[2] = "";
       for (JsonPair pair: variant.as<JsonObject>()) {
         bool found = false;
@@ -229,34 +238,34 @@
         }
         // std::vector<char *>::iterator itr = find(charList.begin(), charList.end(), pair.key().c_str());
         if (!found) { //not found
-          f.printf("%s\"%s\":", sep, pair.key().c_str());
+          out->printf("%s\"%s\":", sep, pair.key().c_str());
           strlcpy(sep, ",", sizeof(sep));
           writeJsonVariantToFile(pair.value());
         }
       }
-      f.printf("}");
+      out->printf("}");
     }
     else if (variant.is<JsonArray>()) {
-      f.printf("[");
+      out->printf("[");
       char sep[2] = "";
       for (JsonVariant variant2: variant.as<JsonArray>()) {
-        f.print(sep);
+        out->print(sep);
         strlcpy(sep, ",", sizeof(sep));
         writeJsonVariantToFile(variant2);
       }      
-      f.printf("]");
+      out->printf("]");
     }
     else if (variant.is<const char *>()) {
-      f.printf("\"%s\"", variant.as<const char *>());      
+      out->printf("\"%s\"", variant.as<const char *>());      
     }
     else if (variant.is<int>()) {
-      f.printf("%d", variant.as<int>());      
+      out->printf("%d", variant.as<int>());      
     }
     else if (variant.is<bool>()) {
-      f.printf("%s", variant.as<bool>()?"true":"false");      
+      out->printf("%s", variant.as<bool>()?"true":"false");      
     }
     else if (variant.isNull()) {
-      f.print("null");      
+      out->print("null");      
     }
     else
       ppf("dev StarJson write %s not supported\n", variant.as<String>().c_str());
@@ -15,6 +15,18 @@
 
 #include <vector>
 
+//Print which only counts and hashes (FNV-1a) the bytes printed, used to skip writing unchanged files
+struct HashPrint: Print {
+  uint32_t hash = 2166136261;
+  size_t length = 0;
+
+  size_t write(uint8_t c) override {
+    hash = (hash ^ c) * 16777619;
+    length++;
+    return 1;
+  }
+};
+
 //Lazy Json Read Deserialize Write Serialize (write / serialize not implemented yet)
 //ArduinoJson won't work on very large fixture.json, this does
 //only support what is currently needed: read / deserialize uint8/16/char var elements (arrays not yet)
@@ -30,6 +42,8 @@ class StarJson {
 
   //serializeJson
   void writeJsonDocToFile(JsonDocument* dest);
+  //serializeJson to any Print (e.g. HashPrint to check if a file needs to be written), path can be nullptr
+  void writeJsonDocToPrint(JsonDocument* dest, Print &print);
 
   //look for uint8 var
   // void lookFor(const char * id, uint8_t * value) {
@@ -56,6 +70,7 @@ private:
   };
 
   File f;
+  Print *out = nullptr; //f or the Print of writeJsonDocToPrint
   byte character; //the last character parsed
   std::vector<VarDetails> varDetails; //details of vars looking for
   std::vector<uint8_t *> uint8List; //pointer of uint8 to assign found values to (index of list stored in varDetails)
@@ -157,6 +157,7 @@ void SysModule::addPresets(JsonObject parentVar) {
 
     if (presetIndex != presetValue) presetVariable.setValue(presetIndex); //set the new value, if changed
 
+    mdl->requestWriteModel(); //presets.json
   });
 
   currentVar = ui->initButton(parentVariable, "clearPreset", false); //clear preset
@@ -198,6 +199,8 @@ void SysModule::addPresets(JsonObject parentVar) {
         presetVariable.publish(onUI); //reload ui for new list of values
 
         if (presetIndex != presetValue) presetVariable.setValue(presetIndex); //set the new value, if changed
+
+        mdl->requestWriteModel(); //presets.json
       }
     }
 
@@ -120,7 +120,10 @@ public:
         packet_buffer[17] = packetSize;
 
         // bulk copy the buffer range to the packet buffer after the header 
-        memcpy(packet_buffer+18, (&fix->ledsP[0].r)+bufferOffset, packetSize); //start from the first byte of ledsP[0]
+        //ledsP has exactly nrOfLeds, send black for channels beyond
+        size_t bytesAvailable = bufferOffset < fix->nrOfLeds * sizeof(CRGB)?fix->nrOfLeds * sizeof(CRGB) - bufferOffset:0;
+        memcpy(packet_buffer+18, (&fix->ledsP[0].r)+bufferOffset, packetSize < bytesAvailable?packetSize:bytesAvailable); //start from the first byte of ledsP[0]
+        if (packetSize > bytesAvailable) memset(packet_buffer+18+bytesAvailable, 0, packetSize - bytesAvailable);
 
         for (int i = 18; i < packetSize+18; i+=sizeof(CRGB)) {
           // set brightness all at once - seems slightly faster than scale8()?